@@ -299,7 +299,7 @@ template <typename Point, typename InStack>
 auto KMeans(const DIA<Point, InStack>&input_points,
             size_t dimensions, size_t num_clusters, size_t iterations) {
 
-    auto points = input_points.Cache();
+    auto points = input_points.CacheInMemory();
 
     using ClosestCentroid = ClosestCentroid<Point>;
     using CentroidAccumulated = CentroidAccumulated<Point>;
@@ -77,7 +77,7 @@ static void RunPageRankEdgePerLine(
             }
             return all;
         },
-        num_pages).Cache();
+        num_pages).CacheInMemory();
 
     // perform actual page rank calculation iterations
 
@@ -130,7 +130,7 @@ static void RunPageRankGenerated(
             size_t /* index */) mutable {
             return graph_gen.GenerateOutgoing(rng);
         },
-        num_pages).Cache();
+        num_pages).CacheInMemory();
 
     // perform actual page rank calculation iterations
 
@@ -45,14 +45,10 @@ auto WordCount(const DIA<std::string, InputStack>&input) {
                 });
         });
 
-    return word_pairs.ReduceByKey(
-        [](const WordCountPair& in) -> std::string {
-            /* reduction key: the word string */
-            return in.first;
-        },
-        [](const WordCountPair& a, const WordCountPair& b) -> WordCountPair {
+    return word_pairs.ReducePair(
+        [](const size_t& a, const size_t& b) -> size_t {
             /* associative reduction operator: add counters */
-            return WordCountPair(a.first, a.second + b.second);
+            return a + b;
         });
 }
 
@@ -123,6 +123,99 @@ TEST(GroupByNode, Median) {
     api::RunLocalTests(start_func);
 }
 
+TEST(GroupByNode, HashMedian) {
+
+    auto start_func =
+        [](Context& ctx) {
+            size_t n = 9999;
+            static constexpr size_t m = 4;
+
+            auto sizets = Generate(ctx, n);
+
+            auto modulo_keyfn = [](size_t in) { return (in % m); };
+
+            auto median_fn =
+                [](auto& r, size_t key) {
+                    std::vector<size_t> all;
+                    while (r.HasNext()) {
+                        size_t v = r.Next();
+                        EXPECT_EQ(key, v % m);
+                        all.push_back(v);
+                    }
+                    std::sort(std::begin(all), std::end(all));
+                    return all[all.size() / 2 - 1];
+                };
+
+            // group by using hash table to compute median and gather results
+            auto reduced = sizets.GroupByKey<size_t>(
+                HashGroupTag, modulo_keyfn, median_fn);
+            std::vector<size_t> out_vec = reduced.AllGather();
+
+            // compute vector with expected results
+            std::vector<std::vector<size_t> > res_vecvec(m);
+            std::vector<size_t> res_vec(m, 0);
+            for (size_t t = 1; t < n; ++t) {
+                res_vecvec[t % m].push_back(t);
+            }
+            for (size_t i = 0; i < res_vecvec.size(); ++i) {
+                std::sort(std::begin(res_vecvec[i]), std::end(res_vecvec[i]));
+                res_vec[i] = res_vecvec[i][res_vecvec[i].size() / 2 - 1];
+            }
+
+            std::sort(out_vec.begin(), out_vec.end());
+            std::sort(res_vec.begin(), res_vec.end());
+
+            ASSERT_EQ(res_vec.size(), out_vec.size());
+            for (size_t i = 0; i < res_vec.size(); ++i) {
+                ASSERT_EQ(res_vec[i], out_vec[i]);
+            }
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+TEST(GroupByNode, HashFallbackToSort) {
+
+    auto start_func =
+        [](Context& ctx) {
+            size_t n = 1000000;
+            static constexpr size_t m = 1000;
+
+            auto sizets = Generate(ctx, n);
+
+            auto modulo_keyfn = [](size_t in) { return (in % m); };
+
+            auto sum_fn =
+                [](auto& r, size_t key) {
+                    size_t sum = 0;
+                    while (r.HasNext()) {
+                        size_t v = r.Next();
+                        EXPECT_EQ(key, v % m);
+                        sum += v;
+                    }
+                    return sum;
+                };
+
+            // with little RAM, the items and hash index do not fit into the
+            // memory limit, hence the node falls back to sorting
+            auto grouped = sizets.GroupByKey<size_t>(
+                HashGroupTag, modulo_keyfn, sum_fn);
+            size_t sum = grouped.Sum();
+
+            ASSERT_EQ(n * (n - 1) / 2, sum);
+
+            using GroupByNode = api::GroupByNode<
+                      size_t, decltype(sizets), decltype(modulo_keyfn),
+                      decltype(sum_fn), std::hash<size_t>,
+                      /* UseHashing */ true>;
+            auto node = dynamic_cast<GroupByNode*>(grouped.node().get());
+            ASSERT_TRUE(node != nullptr);
+            ASSERT_FALSE(node->hash_grouped());
+        };
+
+    api::RunLocalTests(64 * 1024 * 1024, start_func);
+}
+
 TEST(GroupByNode, GroupToIndexCorrectResults) {
 
     auto start_func =
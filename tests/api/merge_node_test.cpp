@@ -184,4 +184,42 @@ TEST(MergeNode, TwoIntegerArraysOfDifferentSize) {
     api::RunLocalTests(start_func);
 }
 
+TEST(MergeNode, TwoIntegerArraysWithDuplicates) {
+
+    static constexpr size_t test_size = 50000;
+
+    auto start_func =
+        [](Context& ctx) {
+
+            // numbers in 0..99, each repeated 500 times
+            auto merge_input1 = Generate(
+                ctx,
+                [](size_t index) { return index / 500; },
+                test_size);
+
+            // numbers in 50..149, each repeated 250 times
+            auto merge_input2 = Generate(
+                ctx,
+                [](size_t index) { return 50 + index / 250; },
+                test_size / 2);
+
+            std::vector<size_t> expected;
+            expected.reserve(test_size + test_size / 2);
+
+            for (size_t i = 0; i < test_size; i++) {
+                expected.push_back(i / 500);
+            }
+
+            for (size_t i = 0; i < test_size / 2; i++) {
+                expected.push_back(50 + i / 250);
+            }
+
+            std::sort(expected.begin(), expected.end());
+
+            DoMergeAndCheckResult(expected, merge_input1, merge_input2);
+        };
+
+    api::RunLocalTests(start_func);
+}
+
 /******************************************************************************/
@@ -10,11 +10,14 @@
  ******************************************************************************/
 
 #include <thrill/api/all_gather.hpp>
+#include <thrill/api/approx_distinct_count.hpp>
 #include <thrill/api/bernoulli_sample.hpp>
+#include <thrill/api/broadcast_join.hpp>
 #include <thrill/api/cache.hpp>
 #include <thrill/api/collapse.hpp>
 #include <thrill/api/concat.hpp>
 #include <thrill/api/concat_to_dia.hpp>
+#include <thrill/api/distinct.hpp>
 #include <thrill/api/distribute.hpp>
 #include <thrill/api/equal_to_dia.hpp>
 #include <thrill/api/gather.hpp>
@@ -23,6 +26,7 @@
 #include <thrill/api/prefixsum.hpp>
 #include <thrill/api/print.hpp>
 #include <thrill/api/read_lines.hpp>
+#include <thrill/api/rebalance.hpp>
 #include <thrill/api/sample.hpp>
 #include <thrill/api/size.hpp>
 #include <thrill/api/sum.hpp>
@@ -36,6 +40,7 @@
 #include <algorithm>
 #include <functional>
 #include <random>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -227,6 +232,89 @@ TEST(Operations, GenerateIntegers) {
     api::RunLocalTests(start_func);
 }
 
+TEST(Operations, CacheInMemoryIterate) {
+
+    static constexpr size_t test_size = 1000;
+
+    auto start_func =
+        [](Context& ctx) {
+
+            auto vectors = Generate(
+                ctx,
+                [](const size_t& index) {
+                    return std::vector<size_t>(index % 5, index);
+                },
+                test_size).CacheInMemory();
+
+            // CacheInMemory() of a cached DIA is the same DIA
+            ASSERT_EQ(vectors.node(), vectors.CacheInMemory().node());
+
+            size_t expected = 0;
+            for (size_t i = 0; i < test_size; ++i)
+                expected += (i % 5) * i;
+
+            // push cached items multiple times
+            for (size_t iter = 0; iter < 3; ++iter) {
+                size_t sum = vectors.Map(
+                    [iter](const std::vector<size_t>& v) {
+                        size_t s = 0;
+                        for (const size_t& x : v) s += x;
+                        return s + iter;
+                    }).Sum();
+                ASSERT_EQ(expected + iter * test_size, sum);
+            }
+
+            std::vector<std::vector<size_t> > out_vec = vectors.AllGather();
+            ASSERT_EQ(test_size, out_vec.size());
+            for (size_t i = 0; i < test_size; ++i) {
+                ASSERT_EQ(std::vector<size_t>(i % 5, i), out_vec[i]);
+            }
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+TEST(Operations, CacheInMemorySpills) {
+
+    static constexpr size_t test_size = 400000;
+
+    auto start_func =
+        [](Context& ctx) {
+
+            // the strings' heap memory exceeds the node's share of the RAM
+            auto strings = Generate(
+                ctx,
+                [](const size_t& index) {
+                    return std::to_string(index) + std::string(100, 'x');
+                },
+                test_size).CacheInMemory();
+
+            size_t size = strings.Size();
+            ASSERT_EQ(test_size, size);
+
+            auto node = dynamic_cast<api::CacheNodeBase<std::string>*>(
+                strings.node().get());
+            ASSERT_TRUE(node != nullptr);
+            ASSERT_FALSE(node->in_memory());
+
+            // push spilled items multiple times
+            for (size_t iter = 0; iter < 2; ++iter) {
+                size_t length = strings.Map(
+                    [](const std::string& s) { return s.size(); }).Sum();
+                size_t expected = 100 * test_size;
+                for (size_t i = 0; i < test_size; ++i)
+                    expected += std::to_string(i).size();
+                ASSERT_EQ(expected, length);
+            }
+        };
+
+    // set fixed amount of RAM for testing
+    api::MemoryConfig mem_config;
+    mem_config.setup(64 * 1024 * 1024llu);
+
+    api::RunLocalMock(mem_config, 2, 1, start_func);
+}
+
 TEST(Operations, GenerateAndConcatTwo) {
 
     static constexpr size_t test_size = 1024;
@@ -705,6 +793,193 @@ TEST(Operations, Sample) {
     api::RunLocalTests(start_func);
 }
 
+TEST(Operations, Distinct) {
+
+    auto start_func =
+        [](Context& ctx) {
+            size_t n = 10000, m = 777;
+
+            auto integers = Generate(
+                ctx,
+                [m](const size_t& index) {
+                    return (index * index) % m;
+                },
+                n);
+
+            std::vector<size_t> out_vec = integers.Distinct().AllGather();
+            std::sort(out_vec.begin(), out_vec.end());
+
+            // compute expected set of distinct items
+            std::vector<size_t> res_vec;
+            for (size_t i = 0; i < n; ++i)
+                res_vec.push_back((i * i) % m);
+            std::sort(res_vec.begin(), res_vec.end());
+            res_vec.erase(std::unique(res_vec.begin(), res_vec.end()),
+                          res_vec.end());
+
+            ASSERT_EQ(res_vec, out_vec);
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+TEST(Operations, DistinctSpilling) {
+
+    auto start_func =
+        [](Context& ctx) {
+            size_t n = 2000000, m = 1500000;
+
+            // with little RAM, the received items are spilled into partitions
+            auto integers = Generate(ctx, n)
+                            .Map([m](const size_t& i) { return i % m; });
+            auto distinct = integers.Distinct();
+
+            ASSERT_EQ(m, distinct.Size());
+
+            using DistinctNode = api::DistinctNode<
+                      size_t, decltype(integers), std::hash<size_t> >;
+            auto node = dynamic_cast<DistinctNode*>(distinct.node().get());
+            ASSERT_TRUE(node != nullptr);
+            ASSERT_LT(0u, ctx.net.AllReduce(node->num_spill_files()));
+        };
+
+    // set fixed amount of RAM for testing
+    api::MemoryConfig mem_config;
+    mem_config.setup(64 * 1024 * 1024llu);
+
+    api::RunLocalMock(mem_config, 2, 1, start_func);
+}
+
+TEST(Operations, ApproxDistinctCount) {
+
+    auto start_func =
+        [](Context& ctx) {
+            // small cardinality: linear counting is nearly exact
+            size_t small = Generate(ctx, 100000)
+                           .Map([](const size_t& i) { return i % 1000; })
+                           .ApproxDistinctCount();
+
+            ASSERT_NEAR(1000.0, static_cast<double>(small), 1000.0 * 0.05);
+
+            // large cardinality: standard error is about 0.8% with 2^14
+            // registers
+            size_t large = Generate(ctx, 200000)
+                           .Map([](const size_t& i) { return i / 2; })
+                           .ApproxDistinctCount(14);
+
+            ASSERT_NEAR(100000.0, static_cast<double>(large), 100000.0 * 0.05);
+
+            // invalid precision is rejected before allocating the registers
+            ASSERT_THROW(Generate(ctx, 100).ApproxDistinctCount(40),
+                         std::invalid_argument);
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+TEST(Operations, BroadcastJoin) {
+
+    auto start_func =
+        [](Context& ctx) {
+            size_t n = 10000, m = 100;
+
+            using Pair = std::pair<size_t, size_t>;
+
+            auto large = Generate(ctx, n);
+
+            // small side contains keys [0,m) with two items for even keys
+            auto small = Generate(ctx, m + m / 2)
+                         .Map([m](const size_t& i) {
+                                  return i < m ? Pair(i, i * i)
+                                  : Pair(2 * (i - m), 0);
+                              });
+
+            std::vector<Pair> out_vec =
+                large.BroadcastJoin(
+                    small,
+                    [m](const size_t& i) { return i % (2 * m); },
+                    [](const Pair& p) { return p.first; },
+                    [](const size_t& i, const Pair& p) {
+                        return Pair(i, p.second);
+                    })
+                .AllGather();
+
+            // compute expected join result
+            std::vector<Pair> res_vec;
+            for (size_t i = 0; i < n; ++i) {
+                size_t k = i % (2 * m);
+                if (k >= m) continue;
+                res_vec.emplace_back(i, k * k);
+                if (k % 2 == 0) res_vec.emplace_back(i, 0);
+            }
+
+            std::sort(out_vec.begin(), out_vec.end());
+            std::sort(res_vec.begin(), res_vec.end());
+            ASSERT_EQ(res_vec, out_vec);
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+TEST(Operations, BroadcastJoinSmallSideTooLarge) {
+
+    auto start_func =
+        [](Context& ctx) {
+            size_t n = 1000000;
+
+            auto large = Generate(ctx, 100);
+            auto small = Generate(ctx, n);
+
+            // with little RAM, the index of the small side does not fit
+            auto joined = large.BroadcastJoin(
+                small,
+                [](const size_t& i) { return i; },
+                [](const size_t& i) { return i; },
+                [](const size_t& a, const size_t& b) { return a + b; });
+
+            ASSERT_THROW(joined.Size(), std::runtime_error);
+        };
+
+    // set fixed amount of RAM for testing
+    api::MemoryConfig mem_config;
+    mem_config.setup(64 * 1024 * 1024llu);
+
+    api::RunLocalMock(mem_config, 2, 1, start_func);
+}
+
+TEST(Operations, Rebalance) {
+
+    auto start_func =
+        [](Context& ctx) {
+            size_t n = 10000;
+
+            // keep only the first tenth of the items, which are all located on
+            // the first workers.
+            auto skewed = Generate(ctx, n)
+                          .Filter([n](const size_t& i) { return i < n / 10; })
+                          .Rebalance().Keep();
+
+            // count the number of items located on this worker
+            size_t local_size = 0;
+            skewed.Map([&local_size](const size_t& i) {
+                           ++local_size;
+                           return i;
+                       }).Size();
+
+            size_t per_pe = n / 10 / ctx.num_workers();
+            ASSERT_GE(local_size, per_pe);
+            ASSERT_LE(local_size, per_pe + 1);
+
+            // order of the items must be unchanged
+            std::vector<size_t> out_vec = skewed.AllGather();
+            ASSERT_EQ(n / 10, out_vec.size());
+            for (size_t i = 0; i < out_vec.size(); ++i)
+                ASSERT_EQ(i, out_vec[i]);
+        };
+
+    api::RunLocalTests(start_func);
+}
+
 TEST(Operations, ForLoop) {
 
     auto start_func =
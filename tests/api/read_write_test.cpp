@@ -19,12 +19,17 @@
 #include <thrill/api/write_binary.hpp>
 #include <thrill/api/write_lines.hpp>
 #include <thrill/api/write_lines_many.hpp>
+#include <thrill/common/die.hpp>
 #include <thrill/common/logger.hpp>
 #include <thrill/common/system_exception.hpp>
 #include <thrill/core/file_io.hpp>
 
 #include <sys/stat.h>
 
+#if THRILL_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
 #include <algorithm>
 #include <cstdlib>
 #include <fstream>
@@ -136,6 +141,169 @@ TEST(IO, WriteBinaryPatternFormatter) {
     ASSERT_EQ("test00420000000010", str2);
 }
 
+TEST(IO, WriteReadLinesManyBlocks) {
+    core::TemporaryDirectory tmpdir;
+
+    api::RunLocalTests(
+        [&tmpdir](api::Context& ctx) {
+
+            // wipe directory from last test
+            if (ctx.my_rank() == 0) {
+                tmpdir.wipe();
+            }
+            ctx.net.Barrier();
+
+            // generate lines of varying length, which span multiple read
+            // blocks of ReadLines.
+            size_t generate_size = 100000;
+            auto make_line = [](size_t index) {
+                                 return std::to_string(index) + ':' +
+                                        std::string(index % 97, 'x');
+                             };
+            {
+                Generate(ctx, make_line, generate_size)
+                .WriteLinesMany(tmpdir.get() + "/IO.Lines",
+                                3 * 1024 * 1024);
+            }
+            ctx.net.Barrier();
+
+            // read the lines from disk (collectively) and compare
+            {
+                std::vector<std::string> vec =
+                    ReadLines(ctx, tmpdir.get() + "/IO.Lines*").AllGather();
+
+                ASSERT_EQ(generate_size, vec.size());
+                for (size_t i = 0; i < vec.size(); ++i) {
+                    ASSERT_EQ(make_line(i), vec[i]);
+                }
+            }
+        });
+}
+
+#if THRILL_HAVE_ZLIB
+
+//! write data as BGZF file with blocks of block_size uncompressed bytes.
+static void WriteBgzfFile(const std::string& path, const std::string& data,
+                          size_t block_size) {
+    std::ofstream out(path, std::ios::binary);
+
+    auto write_block = [&out](const char* p, size_t size) {
+                           std::vector<unsigned char> cdata(
+                               compressBound(size) + 64);
+
+                           z_stream zs = z_stream();
+                           // raw deflate stream without zlib header
+                           die_unless(deflateInit2(
+                                          &zs, Z_DEFAULT_COMPRESSION,
+                                          Z_DEFLATED, -15, 8,
+                                          Z_DEFAULT_STRATEGY) == Z_OK);
+                           zs.next_in = reinterpret_cast<Bytef*>(
+                               const_cast<char*>(p));
+                           zs.avail_in = static_cast<uInt>(size);
+                           zs.next_out = cdata.data();
+                           zs.avail_out = static_cast<uInt>(cdata.size());
+                           die_unless(deflate(&zs, Z_FINISH) == Z_STREAM_END);
+                           size_t csize = zs.total_out;
+                           deflateEnd(&zs);
+
+                           uint32_t crc = crc32(
+                               0, reinterpret_cast<const Bytef*>(p),
+                               static_cast<uInt>(size));
+                           size_t bsize = csize + 18 + 8 - 1;
+
+                           unsigned char header[18] = {
+                               31, 139, 8, 4, 0, 0, 0, 0, 0, 255, 6, 0,
+                               'B', 'C', 2, 0,
+                               static_cast<unsigned char>(bsize & 0xFF),
+                               static_cast<unsigned char>(bsize >> 8)
+                           };
+                           unsigned char trailer[8];
+                           for (size_t i = 0; i < 4; ++i) {
+                               trailer[i] =
+                                   static_cast<unsigned char>(crc >> (8 * i));
+                               trailer[4 + i] =
+                                   static_cast<unsigned char>(size >> (8 * i));
+                           }
+
+                           out.write(reinterpret_cast<char*>(header), 18);
+                           out.write(reinterpret_cast<char*>(cdata.data()),
+                                     csize);
+                           out.write(reinterpret_cast<char*>(trailer), 8);
+                       };
+
+    for (size_t i = 0; i < data.size(); i += block_size)
+        write_block(data.data() + i, std::min(block_size, data.size() - i));
+    // empty end-of-file block
+    write_block(nullptr, 0);
+}
+
+TEST(IO, ReadLinesBgzfSplit) {
+    core::TemporaryDirectory tmpdir;
+
+    // generate lines of varying length, some longer than a BGZF block.
+    size_t generate_size = 20000;
+    auto make_line = [](size_t index) {
+                         return std::to_string(index) + ':' +
+                                std::string(index % 4001 == 0 ? 10000
+                                            : index % 97, 'x');
+                     };
+
+    // write the first half into a BGZF file, and the rest uncompressed.
+    {
+        std::string data;
+        for (size_t i = 0; i < generate_size / 2; ++i)
+            data += make_line(i) + '\n';
+        WriteBgzfFile(tmpdir.get() + "/IO.Bgzf1.gz", data, 4096);
+
+        std::ofstream out(tmpdir.get() + "/IO.Bgzf2");
+        for (size_t i = generate_size / 2; i < generate_size; ++i)
+            out << make_line(i) << '\n';
+    }
+
+    api::RunLocalTests(
+        [&](api::Context& ctx) {
+            std::vector<std::string> vec =
+                ReadLines(ctx, tmpdir.get() + "/IO.Bgzf*").AllGather();
+
+            ASSERT_EQ(generate_size, vec.size());
+            for (size_t i = 0; i < vec.size(); ++i) {
+                ASSERT_EQ(make_line(i), vec[i]);
+            }
+        });
+}
+
+TEST(IO, ReadGzipTrailingZeros) {
+    core::TemporaryDirectory tmpdir;
+    std::string path = tmpdir.get() + "/IO.GzipPadded.gz";
+
+    // write two concatenated gzip members, followed by zero padding as
+    // written e.g. by tape archivers.
+    std::string data1(100000, 'a'), data2 = "concatenated member\n";
+    for (const std::string& data : { data1, data2 }) {
+        gzFile gz = gzopen(path.c_str(), "ab");
+        die_unless(gz != nullptr);
+        die_unless(gzwrite(gz, data.data(), static_cast<unsigned>(data.size()))
+                   == static_cast<int>(data.size()));
+        die_unless(gzclose(gz) == Z_OK);
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out << std::string(1024, '\0');
+    }
+
+    core::SysFile file = core::SysFile::OpenForRead(path);
+    std::string result;
+    char buffer[4096];
+    ssize_t rb;
+    while ((rb = file.read(buffer, sizeof(buffer))) > 0)
+        result.append(buffer, static_cast<size_t>(rb));
+
+    ASSERT_EQ(0, rb);
+    ASSERT_EQ(data1 + data2, result);
+}
+
+#endif // THRILL_HAVE_ZLIB
+
 TEST(IO, GenerateIntegerWriteReadBinary) {
     core::TemporaryDirectory tmpdir;
 
@@ -10,7 +10,9 @@
  ******************************************************************************/
 
 #include <gtest/gtest.h>
+#include <thrill/api/aggregate_by_key.hpp>
 #include <thrill/api/all_gather.hpp>
+#include <thrill/api/cache.hpp>
 #include <thrill/api/generate.hpp>
 #include <thrill/api/reduce_by_key.hpp>
 #include <thrill/api/reduce_to_index.hpp>
@@ -102,6 +104,235 @@ TEST(ReduceNode, ReduceModuloPairsCorrectResults) {
     api::RunLocalTests(start_func);
 }
 
+//! Test ReduceByKey with SortedKeyTag, which delivers the sums sorted by key
+TEST(ReduceNode, ReduceModuloPairsSortedByKey) {
+
+    static constexpr size_t test_size = 100000u;
+    static constexpr size_t mod_size = 1000u;
+    static constexpr size_t div_size = test_size / mod_size;
+
+    auto start_func =
+        [](Context& ctx) {
+
+            using IntPair = std::pair<size_t, size_t>;
+
+            // keys in scattered order: index * 7919 % mod_size
+            auto integers = Generate(
+                ctx,
+                [](const size_t& index) {
+                    return IntPair((index * 7919) % mod_size, index / mod_size);
+                },
+                test_size);
+
+            auto reduced = integers.ReduceByKey(
+                SortedKeyTag,
+                [](const IntPair& p) { return p.first; },
+                [](const IntPair& a, const IntPair& b) {
+                    return IntPair(a.first, a.second + b.second);
+                });
+
+            std::vector<IntPair> out_vec = reduced.AllGather();
+
+            ASSERT_EQ(mod_size, out_vec.size());
+            for (size_t i = 0; i < out_vec.size(); ++i) {
+                ASSERT_EQ(i, out_vec[i].first);
+                ASSERT_EQ(out_vec[i].second, (div_size * (div_size - 1)) / 2u);
+            }
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+//! Test that SortedKeyTag balances the output if the workers hold very
+//! different numbers of keys
+TEST(ReduceNode, ReduceSkewedPairsSortedByKey) {
+
+    static constexpr size_t test_size = 100000u;
+
+    auto start_func =
+        [](Context& ctx) {
+
+            using IntPair = std::pair<size_t, size_t>;
+
+            // unique keys, worker 0 keeps 100 times more than the others
+            auto integers =
+                Generate(
+                    ctx,
+                    [](const size_t& index) { return IntPair(index, 1); },
+                    test_size)
+                .Filter([&ctx](const IntPair& p) {
+                            return ctx.my_rank() == 0 || p.first % 100 == 0;
+                        });
+
+            auto reduced = integers.ReduceByKey(
+                SortedKeyTag,
+                [](const IntPair& p) { return p.first; },
+                [](const IntPair& a, const IntPair& b) {
+                    return IntPair(a.first, a.second + b.second);
+                });
+
+            size_t local_size = 0;
+            std::vector<IntPair> out_vec =
+                reduced.Map([&local_size](const IntPair& p) {
+                                ++local_size;
+                                return p;
+                            }).AllGather();
+
+            for (size_t i = 1; i < out_vec.size(); ++i)
+                ASSERT_LT(out_vec[i - 1].first, out_vec[i].first);
+
+            size_t max_size =
+                ctx.net.AllReduce(local_size, common::maximum<size_t>());
+            ASSERT_LE(max_size,
+                      out_vec.size() * 3 / 2 / ctx.num_workers() + 10);
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+//! Test ReduceByKey with DuplicateDetectionTag on mostly unique keys
+TEST(ReduceNode, ReduceDuplicateDetectionMostlyUniqueKeys) {
+
+    static constexpr size_t test_size = 100000u;
+
+    auto start_func =
+        [](Context& ctx) {
+
+            using IntPair = std::pair<size_t, size_t>;
+
+            // keys 0..test_size-1, and multiples of ten once more
+            auto integers = Generate(
+                ctx,
+                [](const size_t& index) {
+                    size_t key =
+                        index < test_size ? index : (index - test_size) * 10;
+                    return IntPair(key, 1);
+                },
+                test_size + test_size / 10);
+
+            auto reduced = integers.ReduceByKey(
+                DuplicateDetectionTag,
+                [](const IntPair& p) { return p.first; },
+                [](const IntPair& a, const IntPair& b) {
+                    return IntPair(a.first, a.second + b.second);
+                });
+
+            std::vector<IntPair> out_vec = reduced.AllGather();
+
+            std::sort(out_vec.begin(), out_vec.end());
+
+            ASSERT_EQ(test_size, out_vec.size());
+            for (size_t i = 0; i < out_vec.size(); ++i) {
+                ASSERT_EQ(i, out_vec[i].first);
+                ASSERT_EQ(i % 10 == 0 ? 2u : 1u, out_vec[i].second);
+            }
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+//! Test AggregateByKey by calculating the mean of each residue class
+TEST(ReduceNode, AggregateByKeyMean) {
+
+    static constexpr size_t test_size = 100000u;
+    static constexpr size_t mod_size = 100u;
+
+    auto start_func =
+        [](Context& ctx) {
+
+            // accumulator: count and sum of items
+            using CountSum = std::pair<size_t, size_t>;
+            using KeyMean = std::pair<size_t, double>;
+
+            auto integers = Generate(ctx, test_size);
+
+            auto key = [](const size_t& in) { return in % mod_size; };
+
+            auto add = [](const CountSum& a, const size_t& in) {
+                           return CountSum(a.first + 1, a.second + in);
+                       };
+
+            auto merge = [](const CountSum& a, const CountSum& b) {
+                             return CountSum(a.first + b.first,
+                                             a.second + b.second);
+                         };
+
+            auto finish = [](const size_t& k, const CountSum& a) {
+                              return KeyMean(
+                                  k, static_cast<double>(a.second) /
+                                  static_cast<double>(a.first));
+                          };
+
+            auto means = integers.AggregateByKey(
+                key, CountSum(0, 0), add, merge, finish);
+
+            std::vector<KeyMean> out_vec = means.AllGather();
+
+            std::sort(out_vec.begin(), out_vec.end());
+
+            ASSERT_EQ(mod_size, out_vec.size());
+
+            for (size_t i = 0; i < out_vec.size(); ++i) {
+                size_t count = test_size / mod_size;
+                // sum of i + j * mod_size for j = 0..count-1
+                double sum = static_cast<double>(
+                    i * count + mod_size * count * (count - 1) / 2);
+                ASSERT_EQ(i, out_vec[i].first);
+                ASSERT_DOUBLE_EQ(sum / static_cast<double>(count),
+                                 out_vec[i].second);
+            }
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+//! Test that AggregateByKey adds items to the accumulator in the table: each
+//! initial accumulator counts as one part, hence the number of merged parts of
+//! a key is much smaller than its number of items if items are added in place.
+TEST(ReduceNode, AggregateByKeyAddsInPlace) {
+
+    static constexpr size_t test_size = 100000u;
+    static constexpr size_t mod_size = 100u;
+
+    auto start_func =
+        [](Context& ctx) {
+
+            // accumulator: count of items and number of merged parts
+            using CountParts = std::pair<size_t, size_t>;
+
+            auto integers = Generate(ctx, test_size);
+
+            auto key = [](const size_t& in) { return in % mod_size; };
+
+            auto add = [](const CountParts& a, const size_t&) {
+                           return CountParts(a.first + 1, a.second);
+                       };
+
+            auto merge = [](const CountParts& a, const CountParts& b) {
+                             return CountParts(a.first + b.first,
+                                               a.second + b.second);
+                         };
+
+            auto finish = [](const size_t&, const CountParts& a) {
+                              return a;
+                          };
+
+            auto parts = integers.AggregateByKey(
+                key, CountParts(0, 1), add, merge, finish);
+
+            std::vector<CountParts> out_vec = parts.AllGather();
+
+            ASSERT_EQ(mod_size, out_vec.size());
+
+            for (const CountParts& p : out_vec) {
+                ASSERT_EQ(test_size / mod_size, p.first);
+                ASSERT_LT(10 * p.second, p.first);
+            }
+        };
+
+    api::RunLocalTests(start_func);
+}
+
 TEST(ReduceNode, ReduceToIndexCorrectResults) {
 
     auto start_func =
@@ -169,4 +400,96 @@ TEST(ReduceNode, ReduceToIndexCorrectResults) {
     api::RunLocalTests(start_func);
 }
 
+class ReduceToIndexHashConfig : public api::DefaultReduceToIndexConfig
+{
+public:
+    static constexpr bool use_dense_array_ = false;
+};
+
+TEST(ReduceNode, ReduceToIndexDenseEqualsHash) {
+
+    auto start_func =
+        [](Context& ctx) {
+
+            static constexpr size_t result_size = 1000;
+
+            auto integers = Generate(
+                ctx,
+                [](const size_t& index) { return index; },
+                10000).Cache();
+
+            auto key = [](size_t in) { return (in * 7) % result_size; };
+            auto add_function = [](const size_t& in1, const size_t& in2) {
+                                    return in1 + in2;
+                                };
+
+            std::vector<size_t> dense_vec =
+                integers.ReduceToIndex(
+                    VolatileKeyTag, key, add_function, result_size)
+                .AllGather();
+
+            std::vector<size_t> hash_vec =
+                integers.ReduceToIndex(
+                    VolatileKeyTag, key, add_function, result_size,
+                    size_t(), ReduceToIndexHashConfig())
+                .AllGather();
+
+            ASSERT_EQ(result_size, dense_vec.size());
+            ASSERT_EQ(dense_vec, hash_vec);
+
+            // each index k receives the ten items i = j * 1000 + (k * 143) %
+            // 1000, since 7 * 143 = 1001.
+            for (size_t k = 0; k < result_size; ++k) {
+                size_t r = (k * 143) % result_size;
+                ASSERT_EQ(10 * r + 45 * result_size, dense_vec[k]);
+            }
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+
+TEST(ReduceNode, ReduceToIndexDenseStringsEqualsHash) {
+
+    auto start_func =
+        [](Context& ctx) {
+
+            // std::string is not trivially copyable, hence the dense arrays
+            // are combined via the stream. Indexes 50..59 receive no items.
+            static constexpr size_t result_size = 60;
+
+            auto strings = Generate(
+                ctx,
+                [](const size_t& index) { return std::to_string(index); },
+                10000).Cache();
+
+            auto key = [](const std::string& in) {
+                           return std::stoul(in) % 50;
+                       };
+            auto max_function = [](const std::string& in1,
+                                   const std::string& in2) {
+                                    return std::max(in1, in2);
+                                };
+
+            std::vector<std::string> dense_vec =
+                strings.ReduceToIndex(
+                    key, max_function, result_size, std::string("none"))
+                .AllGather();
+
+            std::vector<std::string> hash_vec =
+                strings.ReduceToIndex(
+                    key, max_function, result_size, std::string("none"),
+                    ReduceToIndexHashConfig())
+                .AllGather();
+
+            ASSERT_EQ(result_size, dense_vec.size());
+            ASSERT_EQ(dense_vec, hash_vec);
+
+            ASSERT_EQ("9999", dense_vec[49]);
+            ASSERT_EQ("none", dense_vec[50]);
+        };
+
+    api::RunLocalTests(start_func);
+}
+
 /******************************************************************************/
@@ -53,6 +53,45 @@ TEST(Sort, SortKnownIntegers) {
     api::RunLocalMock(mem_config, 2, 1, start_func);
 }
 
+TEST(Sort, SortSeveralRunsInBackground) {
+
+    static constexpr size_t test_size = 6000000u;
+
+    auto start_func =
+        [](Context& ctx) {
+
+            auto integers = Generate(
+                ctx,
+                [](const size_t& index) -> size_t {
+                    return (index * 48271) % test_size;
+                },
+                test_size);
+
+            auto sorted = integers.Sort();
+
+            std::vector<size_t> out_vec = sorted.AllGather();
+
+            ASSERT_EQ(test_size, out_vec.size());
+            for (size_t i = 0; i < out_vec.size(); i++) {
+                ASSERT_EQ(i, out_vec[i]);
+            }
+
+            // with little RAM, each worker writes several runs, all but the
+            // last one by the background thread.
+            using SortNode = api::SortNode<
+                      size_t, decltype(integers), std::less<size_t> >;
+            auto node = dynamic_cast<SortNode*>(sorted.node().get());
+            ASSERT_TRUE(node != nullptr);
+            ASSERT_LE(3u, node->num_runs());
+        };
+
+    // set fixed amount of RAM for testing
+    api::MemoryConfig mem_config;
+    mem_config.setup(128 * 1024 * 1024llu);
+
+    api::RunLocalMock(mem_config, 2, 1, start_func);
+}
+
 TEST(Sort, SortRandomIntegers) {
 
     auto start_func =
@@ -82,6 +121,40 @@ TEST(Sort, SortRandomIntegers) {
     api::RunLocalTests(start_func);
 }
 
+TEST(Sort, SortRandomStringsWithCommonPrefixes) {
+
+    auto start_func =
+        [](Context& ctx) {
+
+            std::default_random_engine generator(std::random_device { } ());
+            std::uniform_int_distribution<int> distribution(0, 3);
+
+            // strings from a small alphabet with long common prefixes
+            auto strings = Generate(
+                ctx,
+                [&distribution, &generator](const size_t&) {
+                    std::string s = "http://example.org/";
+                    size_t length = distribution(generator) * 4;
+                    for (size_t i = 0; i < length; ++i)
+                        s += static_cast<char>('a' + distribution(generator));
+                    return s;
+                },
+                10000);
+
+            auto sorted = strings.Sort();
+
+            std::vector<std::string> out_vec = sorted.AllGather();
+
+            for (size_t i = 0; i < out_vec.size() - 1; i++) {
+                ASSERT_FALSE(out_vec[i + 1] < out_vec[i]);
+            }
+
+            ASSERT_EQ(10000u, out_vec.size());
+        };
+
+    api::RunLocalTests(start_func);
+}
+
 TEST(Sort, SortRandomIntegersCustomCompareFunction) {
 
     auto start_func =
@@ -156,6 +229,118 @@ TEST(Sort, SortRandomIntIntStructs) {
     api::RunLocalTests(start_func);
 }
 
+TEST(Sort, SortLargeRecordsWithTags) {
+
+    // 100-byte records, which are sorted via index tags
+    struct Record {
+        uint64_t key;
+        char     payload[92];
+    };
+
+    auto start_func =
+        [](Context& ctx) {
+
+            std::default_random_engine generator(std::random_device { } ());
+            std::uniform_int_distribution<uint64_t> distribution(1, 1000);
+
+            auto records = Generate(
+                ctx,
+                [&distribution, &generator](const size_t&) {
+                    Record r;
+                    r.key = distribution(generator);
+                    std::fill(r.payload, r.payload + sizeof(r.payload),
+                              static_cast<char>(r.key));
+                    return r;
+                },
+                10000);
+
+            auto sorted = records.Sort(
+                [](const Record& a, const Record& b) {
+                    return a.key < b.key;
+                });
+
+            std::vector<Record> out_vec = sorted.AllGather();
+
+            ASSERT_EQ(10000u, out_vec.size());
+            for (size_t i = 0; i < out_vec.size() - 1; i++) {
+                ASSERT_FALSE(out_vec[i + 1].key < out_vec[i].key);
+            }
+            // payloads moved with their keys
+            for (const Record& r : out_vec) {
+                ASSERT_EQ(static_cast<char>(r.key),
+                          r.payload[sizeof(r.payload) - 1]);
+            }
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+TEST(Sort, SortPresortedIntegers) {
+
+    auto start_func =
+        [](Context& ctx) {
+
+            // globally sorted input, which is not shuffled
+            auto integers = Generate(
+                ctx,
+                [](const size_t& index) -> size_t { return index / 3; },
+                10000);
+
+            std::vector<size_t> out_vec = integers.Sort().AllGather();
+
+            ASSERT_EQ(10000u, out_vec.size());
+            for (size_t i = 0; i < out_vec.size(); i++) {
+                ASSERT_EQ(i / 3, out_vec[i]);
+            }
+
+            // nearly sorted input: every 100th item is out of order, sorted
+            // twice to also check a File input.
+            auto nearly = Generate(
+                ctx,
+                [](const size_t& index) -> size_t {
+                    return index % 100 == 0 ? 10000 - index : index;
+                },
+                10000);
+
+            std::vector<size_t> out_vec2 = nearly.Sort().Sort().AllGather();
+
+            ASSERT_EQ(10000u, out_vec2.size());
+            ASSERT_TRUE(std::is_sorted(out_vec2.begin(), out_vec2.end()));
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+TEST(Sort, SortPresortedStrings) {
+
+    auto start_func =
+        [](Context& ctx) {
+
+            // globally sorted strings, whose descents are counted after the
+            // PreOp instead of copying each item.
+            auto make_string = [](size_t index) {
+                                   std::string s = std::to_string(index / 2);
+                                   return std::string(8 - s.size(), '0') + s;
+                               };
+
+            auto strings = Generate(
+                ctx,
+                [&make_string](const size_t& index) {
+                    return make_string(index);
+                },
+                10000);
+
+            std::vector<std::string> out_vec = strings.Sort().AllGather();
+
+            ASSERT_EQ(10000u, out_vec.size());
+            for (size_t i = 0; i < out_vec.size(); i++) {
+                ASSERT_EQ(make_string(i), out_vec[i]);
+            }
+        };
+
+    api::RunLocalTests(start_func);
+}
+
 TEST(Sort, SortZeros) {
 
     auto start_func =
@@ -10,6 +10,7 @@
 
 #include <gtest/gtest.h>
 #include <thrill/api/all_gather.hpp>
+#include <thrill/api/cache.hpp>
 #include <thrill/api/collapse.hpp>
 #include <thrill/api/generate.hpp>
 #include <thrill/api/size.hpp>
@@ -117,6 +118,37 @@ TEST(ZipNode, TwoDisbalancedIntegerArrays) {
     api::RunLocalTests(start_func);
 }
 
+TEST(ZipNode, IterateCoPartitionedArrays) {
+
+    auto start_func =
+        [](Context& ctx) {
+
+            // numbers 0..999 (evenly distributed to workers)
+            auto input = Generate(
+                ctx,
+                [](size_t index) { return index; },
+                test_size).Cache();
+
+            // zip with the result of the previous iteration, which keeps the
+            // distribution of input, hence no items need to be exchanged.
+            DIA<size_t> values = input;
+            for (size_t iter = 0; iter < 3; ++iter) {
+                values = values.Zip(
+                    input, [](size_t a, size_t b) { return a + b; }).Collapse();
+            }
+
+            // check result
+            std::vector<size_t> res = values.AllGather();
+
+            ASSERT_EQ(test_size, res.size());
+            for (size_t i = 0; i != res.size(); ++i) {
+                ASSERT_EQ(4 * i, res[i]);
+            }
+        };
+
+    api::RunLocalTests(start_func);
+}
+
 TEST(ZipNode, TwoIntegerArraysWhereOneIsEmpty) {
 
     auto start_func =
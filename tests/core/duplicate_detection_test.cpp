@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * tests/core/duplicate_detection_test.cpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/api/context.hpp>
+#include <thrill/core/duplicate_detection.hpp>
+#include <thrill/data/file.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace thrill;
+
+//! multiplicative hash spreading keys over all owners
+static uint64_t MulHash(const size_t& key) {
+    return uint64_t(key) * 0x9E3779B97F4A7C15ull;
+}
+
+TEST(DuplicateDetection, FindDuplicatesInSpilledRuns) {
+    static constexpr size_t test_size = 20000;
+    static constexpr size_t shared_size = 100;
+
+    auto start_func =
+        [](Context& ctx) {
+            size_t rank = ctx.my_rank();
+            size_t num_workers = ctx.num_workers();
+
+            // keys unique to this worker, keys shared by all workers, and one
+            // key occurring twice locally.
+            data::File file = ctx.GetFile(nullptr);
+            {
+                auto writer = file.GetWriter();
+                for (size_t i = 0; i < test_size; ++i)
+                    writer.Put<size_t>(shared_size + rank * test_size + i);
+                for (size_t i = 0; i < shared_size; ++i)
+                    writer.Put<size_t>(i);
+                writer.Put<size_t>(size_t(1) << 48);
+                writer.Put<size_t>(size_t(1) << 48);
+                writer.Close();
+            }
+
+            // with no memory, fingerprints are received in minimal runs
+            core::DuplicateDetection dup_detect;
+            dup_detect.FindDuplicates<size_t>(
+                ctx, /* dia_id */ 0, file, MulHash, /* mem_limit */ 0);
+
+            ASSERT_EQ(test_size + shared_size + 2, file.num_items());
+            ASSERT_LT(0u, ctx.net.AllReduce(dup_detect.num_spilled_runs()));
+
+            if (num_workers >= 2) {
+                for (size_t i = 0; i < shared_size; ++i)
+                    ASSERT_TRUE(dup_detect.IsDuplicate(MulHash(i)));
+            }
+            ASSERT_TRUE(dup_detect.IsDuplicate(MulHash(size_t(1) << 48)));
+
+            // unique keys are only reported by fingerprint collisions
+            size_t false_positives = 0;
+            for (size_t i = 0; i < test_size; ++i) {
+                false_positives += dup_detect.IsDuplicate(
+                    MulHash(shared_size + rank * test_size + i));
+            }
+            ASSERT_LT(false_positives, test_size / 100);
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+/******************************************************************************/
@@ -11,6 +11,7 @@
 #include <gtest/gtest.h>
 
 #include <thrill/common/function_traits.hpp>
+#include <thrill/core/multikey_quicksort.hpp>
 #include <thrill/core/multiway_merge.hpp>
 #include <thrill/core/multiway_merge_attic.hpp>
 #include <thrill/data/file.hpp>
@@ -133,4 +134,129 @@ TEST_F(MultiwayMerge, GetMultiwayMergePuller) {
     ASSERT_FALSE(puller.HasNext());
 }
 
+TEST_F(MultiwayMerge, ParallelFiles) {
+    std::mt19937 gen(0);
+    size_t num_files = 7;
+    size_t num_parts = 4;
+
+    std::vector<data::File> in;
+    std::vector<size_t> ref;
+
+    for (size_t i = 0; i < num_files; ++i) {
+        // files of different sizes with many duplicates, one is empty.
+        std::vector<size_t> tmp(i * 1000);
+        for (size_t& elem : tmp) elem = gen() % 500;
+        std::sort(tmp.begin(), tmp.end());
+        ref.insert(ref.end(), tmp.begin(), tmp.end());
+
+        in.emplace_back(block_pool_, 0, /* dia_id */ 0);
+        auto w = in.back().GetWriter(/* block_size */ 1024);
+        for (const size_t& t : tmp) w.Put(t);
+    }
+    std::sort(ref.begin(), ref.end());
+
+    std::vector<data::File> parts;
+    for (size_t p = 0; p < num_parts; ++p)
+        parts.emplace_back(block_pool_, 0, /* dia_id */ 0);
+
+    data::File output(block_pool_, 0, /* dia_id */ 0);
+    core::parallel_multiway_merge_files<size_t>(
+        in.begin(), in.end(), parts, /* prefetch */ 0, std::less<size_t>(),
+        output);
+
+    // the inputs are consumed
+    for (const data::File& file : in)
+        ASSERT_TRUE(file.empty());
+
+    ASSERT_EQ(ref.size(), output.num_items());
+    auto reader = output.GetKeepReader();
+    for (size_t i = 0; i < ref.size(); ++i) {
+        ASSERT_TRUE(reader.HasNext());
+        ASSERT_EQ(ref[i], reader.Next<size_t>());
+    }
+    ASSERT_FALSE(reader.HasNext());
+}
+
+TEST_F(MultiwayMerge, ParallelFilesStrings) {
+    std::mt19937 gen(0);
+    size_t num_files = 5;
+    size_t num_parts = 3;
+
+    std::vector<data::File> in;
+    std::vector<std::string> ref;
+
+    for (size_t i = 0; i < num_files; ++i) {
+        // strings of varying length, some spanning several Blocks.
+        std::vector<std::string> tmp(i * 300);
+        for (std::string& elem : tmp) {
+            elem = std::to_string(gen() % 1000) +
+                   std::string(gen() % 50 == 0 ? 3000 : gen() % 40, 'x');
+        }
+        std::sort(tmp.begin(), tmp.end());
+        ref.insert(ref.end(), tmp.begin(), tmp.end());
+
+        in.emplace_back(block_pool_, 0, /* dia_id */ 0);
+        auto w = in.back().GetWriter(/* block_size */ 1024);
+        for (const std::string& t : tmp) w.Put(t);
+    }
+    std::sort(ref.begin(), ref.end());
+
+    std::vector<data::File> parts;
+    for (size_t p = 0; p < num_parts; ++p)
+        parts.emplace_back(block_pool_, 0, /* dia_id */ 0);
+
+    data::File output(block_pool_, 0, /* dia_id */ 0);
+    core::parallel_multiway_merge_files<std::string>(
+        in.begin(), in.end(), parts, /* prefetch */ 1,
+        std::less<std::string>(), output);
+
+    ASSERT_EQ(ref.size(), output.num_items());
+    auto reader = output.GetKeepReader();
+    for (size_t i = 0; i < ref.size(); ++i) {
+        ASSERT_TRUE(reader.HasNext());
+        ASSERT_EQ(ref[i], reader.Next<std::string>());
+    }
+    ASSERT_FALSE(reader.HasNext());
+}
+
+TEST_F(MultiwayMerge, LcpStrings) {
+    std::mt19937 gen(0);
+    size_t num_files = 5;
+
+    std::vector<data::File> in;
+    std::vector<std::string> ref;
+
+    for (size_t i = 0; i < num_files; ++i) {
+        // strings with long common prefixes, including duplicates and
+        // prefixes of other strings.
+        std::vector<std::string> tmp(i * 300);
+        for (std::string& s : tmp) {
+            s = "prefix";
+            for (size_t j = gen() % 8; j > 0; --j)
+                s += static_cast<char>('a' + gen() % 3);
+        }
+        core::MultikeyQuicksort(tmp.data(), tmp.size());
+        ASSERT_TRUE(std::is_sorted(tmp.begin(), tmp.end()));
+        ref.insert(ref.end(), tmp.begin(), tmp.end());
+
+        in.emplace_back(block_pool_, 0, /* dia_id */ 0);
+        auto w = in.back().GetWriter();
+        for (const std::string& t : tmp) w.Put(t);
+    }
+    std::sort(ref.begin(), ref.end());
+
+    std::vector<data::File::ConsumeReader> seq;
+    for (size_t t = 0; t < in.size(); ++t)
+        seq.emplace_back(in[t].GetConsumeReader());
+
+    auto puller = core::make_multiway_merge_tree<std::string>(
+        seq.begin(), seq.end(), std::less<std::string>());
+
+    for (size_t i = 0; i < ref.size(); ++i) {
+        ASSERT_TRUE(puller.HasNext());
+        ASSERT_EQ(ref[i], puller.Next());
+    }
+    ASSERT_FALSE(puller.HasNext());
+}
+
 /******************************************************************************/
@@ -12,6 +12,7 @@
 #include <thrill/core/reduce_bucket_hash_table.hpp>
 #include <thrill/core/reduce_old_probing_hash_table.hpp>
 #include <thrill/core/reduce_probing_hash_table.hpp>
+#include <thrill/core/reduce_string_probing_hash_table.hpp>
 
 #include <thrill/core/reduce_pre_stage.hpp>
 
@@ -19,6 +20,9 @@
 
 #include <algorithm>
 #include <functional>
+#include <map>
+#include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -138,4 +142,152 @@ TEST(ReduceHashTable, ProbingAddIntegers) {
         });
 }
 
+//! Count words in a string table, also reading back the spilled items unless
+//! the table immediately flushes.
+void TestStringCountWords(Context& ctx, size_t limit_memory_bytes,
+                          bool immediate_flush) {
+    static constexpr size_t test_size = 50000;
+    static constexpr size_t mod_size = 500;
+
+    using KeyValuePair = std::pair<std::string, size_t>;
+
+    auto key_ex = [](const size_t&) { return std::string(); };
+
+    auto red_fn = [](const size_t& a, const size_t& b) { return a + b; };
+
+    using Collector = TableCollector<KeyValuePair>;
+
+    Collector collector(13);
+
+    using Table = core::ReduceTableSelect<
+              core::ReduceTableImpl::PROBING,
+              size_t, std::string, size_t,
+              decltype(key_ex), decltype(red_fn), Collector,
+              /* VolatileKey */ true, core::DefaultReduceConfig,
+              core::ReduceByHash<std::string> >::type;
+
+    static_assert(
+        std::is_same<Table, core::ReduceStringProbingHashTable<
+                                size_t, size_t,
+                                decltype(key_ex), decltype(red_fn), Collector,
+                                true, core::DefaultReduceConfig,
+                                core::ReduceByHash<std::string> > >::value,
+        "ReduceTableSelect must select ReduceStringProbingHashTable");
+
+    Table table(ctx, 0, key_ex, red_fn, collector,
+                /* num_partitions */ 13,
+                core::DefaultReduceConfig(), immediate_flush);
+    table.Initialize(limit_memory_bytes);
+
+    // include the empty string and long words
+    for (size_t i = 0; i < test_size; ++i) {
+        size_t w = i % mod_size;
+        table.Insert(KeyValuePair(
+                         std::string(w % 37, 'a') + std::to_string(w), 1));
+        if (w == 0) table.Insert(KeyValuePair(std::string(), 2));
+    }
+
+    table.FlushAll();
+
+    // collect all items, which may occur multiple times after spilling
+    std::map<std::string, size_t> result;
+
+    for (size_t pi = 0; pi < collector.size(); ++pi) {
+        for (const KeyValuePair& p : collector[pi])
+            result[p.first] += p.second;
+    }
+
+    for (data::File& file : table.partition_files()) {
+        data::File::Reader reader = file.GetReader(/* consume */ true);
+        while (reader.HasNext()) {
+            KeyValuePair p = reader.Next<KeyValuePair>();
+            result[p.first] += p.second;
+        }
+    }
+
+    // check result
+    ASSERT_EQ(mod_size + 1, result.size());
+    ASSERT_EQ(2 * test_size / mod_size, result[std::string()]);
+
+    for (size_t w = 0; w < mod_size; ++w) {
+        ASSERT_EQ(test_size / mod_size,
+                  result[std::string(w % 37, 'a') + std::to_string(w)]);
+    }
+}
+
+TEST(ReduceHashTable, StringProbingCountWords) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            TestStringCountWords(ctx, 1024 * 1024, true);
+        });
+}
+
+TEST(ReduceHashTable, StringProbingCountWordsSpilling) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            TestStringCountWords(ctx, 4 * 1024, false);
+        });
+}
+
+//! Without VolatileKey the values contain their std::string key, hence
+//! ReduceTableSelect must select the generic probing table.
+TEST(ReduceHashTable, StringKeysNonVolatile) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            static constexpr size_t test_size = 50000;
+            static constexpr size_t mod_size = 500;
+
+            using WordCount = std::pair<std::string, size_t>;
+
+            auto key_ex = [](const WordCount& in) { return in.first; };
+
+            auto red_fn = [](const WordCount& a, const WordCount& b) {
+                              return WordCount(a.first, a.second + b.second);
+                          };
+
+            using Collector =
+                      TableCollector<std::pair<std::string, WordCount> >;
+
+            Collector collector(13);
+
+            using Table = core::ReduceTableSelect<
+                      core::ReduceTableImpl::PROBING,
+                      WordCount, std::string, WordCount,
+                      decltype(key_ex), decltype(red_fn), Collector,
+                      /* VolatileKey */ false, core::DefaultReduceConfig,
+                      core::ReduceByHash<std::string> >::type;
+
+            static_assert(
+                std::is_same<Table, core::ReduceProbingHashTable<
+                                 WordCount, std::string, WordCount,
+                                 decltype(key_ex), decltype(red_fn), Collector,
+                                 false, core::DefaultReduceConfig,
+                                 core::ReduceByHash<std::string> > >::value,
+                "ReduceTableSelect must select ReduceProbingHashTable");
+
+            Table table(ctx, 0, key_ex, red_fn, collector,
+                        /* num_partitions */ 13,
+                        core::DefaultReduceConfig(),
+                        /* immediate_flush */ true);
+            table.Initialize(/* limit_memory_bytes */ 1024 * 1024);
+
+            for (size_t i = 0; i < test_size; ++i)
+                table.Insert(WordCount(std::to_string(i % mod_size), 1));
+
+            table.FlushAll();
+
+            std::map<std::string, size_t> result;
+            for (size_t pi = 0; pi < collector.size(); ++pi) {
+                for (const auto& p : collector[pi]) {
+                    ASSERT_EQ(p.first, p.second.first);
+                    result[p.second.first] += p.second.second;
+                }
+            }
+
+            ASSERT_EQ(mod_size, result.size());
+            for (size_t w = 0; w < mod_size; ++w)
+                ASSERT_EQ(test_size / mod_size, result[std::to_string(w)]);
+        });
+}
+
 /******************************************************************************/
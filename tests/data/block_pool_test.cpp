@@ -12,7 +12,10 @@
 #include <thrill/data/block.hpp>
 #include <thrill/data/block_pool.hpp>
 
+#include <algorithm>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace thrill;
 
@@ -109,4 +112,74 @@ TEST_F(BlockPoolTest, EvictBlock) {
     ASSERT_EQ(0u, block_pool_.writing_blocks() + block_pool_.swapped_blocks());
 }
 
+TEST_F(BlockPoolTest, EvictCleanBlockWithoutWriting) {
+    data::Block unpinned_block;
+    {
+        data::PinnedByteBlockPtr block = block_pool_.AllocateByteBlock(4096, 0);
+        std::fill(block->begin(), block->end(), 42);
+        data::PinnedBlock pinned_block(std::move(block), 0, 4096, 0, 0, false);
+        unpinned_block = pinned_block.ToBlock();
+    }
+    // evict block, wait for the write, and swap it back in, this keeps the EM
+    // copy.
+    block_pool_.EvictBlock(unpinned_block.byte_block().get());
+    while (block_pool_.writing_blocks() != 0)
+        std::this_thread::yield();
+    ASSERT_EQ(1u, block_pool_.swapped_blocks());
+    {
+        data::PinnedBlock pinned = unpinned_block.PinWait(0);
+        ASSERT_EQ(1u, block_pool_.clean_blocks());
+        ASSERT_EQ(42u, pinned.data_begin()[4095]);
+    }
+    // wait for the read's PinRequest to release its pin in the I/O thread.
+    while (block_pool_.unpinned_blocks() != 1)
+        std::this_thread::yield();
+    // evict again: no write is needed.
+    block_pool_.EvictBlock(unpinned_block.byte_block().get());
+    ASSERT_EQ(0u, block_pool_.writing_blocks());
+    ASSERT_EQ(1u, block_pool_.swapped_blocks());
+    ASSERT_EQ(0u, block_pool_.clean_blocks());
+    // swap block back in from the same EM copy.
+    {
+        data::PinnedBlock pinned = unpinned_block.PinWait(0);
+        ASSERT_EQ(42u, pinned.data_begin()[0]);
+        ASSERT_EQ(1u, block_pool_.clean_blocks());
+    }
+}
+
+TEST(BlockPoolWriteBack, WriteBackColdBlocks) {
+    static constexpr size_t block_size = 4096;
+    data::BlockPool block_pool(
+        4 * block_size, 64 * block_size, nullptr, nullptr, 1);
+
+    std::vector<data::Block> blocks;
+    for (size_t i = 0; i < 4; ++i) {
+        data::PinnedByteBlockPtr block =
+            block_pool.AllocateByteBlock(block_size, 0);
+        std::fill(block->begin(), block->end(), static_cast<uint8_t>(i));
+        data::PinnedBlock pinned_block(
+            std::move(block), 0, block_size, 0, 0, false);
+        blocks.emplace_back(pinned_block.ToBlock());
+    }
+    ASSERT_EQ(4u, block_pool.unpinned_blocks());
+
+    // RAM usage is above the write-back threshold: the least recently used
+    // block is written to EM, but remains in memory.
+    block_pool.RunTask(std::chrono::steady_clock::now());
+    while (block_pool.writeback_blocks() != 0)
+        std::this_thread::yield();
+    ASSERT_EQ(1u, block_pool.clean_blocks());
+    ASSERT_EQ(4u, block_pool.unpinned_blocks());
+    ASSERT_EQ(0u, block_pool.swapped_blocks());
+
+    // evicting it is free.
+    block_pool.EvictBlockLRU();
+    ASSERT_EQ(0u, block_pool.writing_blocks());
+    ASSERT_EQ(1u, block_pool.swapped_blocks());
+    ASSERT_FALSE(blocks[0].byte_block()->in_memory());
+
+    data::PinnedBlock pinned = blocks[0].PinWait(0);
+    ASSERT_EQ(0u, pinned.data_begin()[block_size - 1]);
+}
+
 /******************************************************************************/
@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <functional>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -247,6 +248,69 @@ TEST_F(File, SerializeSomeItemsConsumeReader) {
     ASSERT_EQ(0u, file.num_items());
 }
 
+TEST_F(File, EvictCoalescedBlocks) {
+    static constexpr size_t size = 5000;
+
+    data::File file(block_pool_, 0, /* dia_id */ 0);
+    {
+        data::File::Writer fw = file.GetWriter(1024);
+        for (unsigned i = 0; i < size; ++i) {
+            fw.Put<unsigned>(i);
+        }
+    }
+    ASSERT_LT(4u, file.num_blocks());
+    ASSERT_EQ(file.num_blocks(), block_pool_.unpinned_blocks());
+
+    // evicting the least recently used block also evicts the following blocks
+    // of the same File into one extent.
+    block_pool_.EvictBlockLRU();
+    ASSERT_EQ(0u, block_pool_.unpinned_blocks());
+    ASSERT_EQ(file.num_blocks(),
+              block_pool_.writing_blocks() + block_pool_.swapped_blocks());
+
+    // read items back from EM
+    data::File::KeepReader fr = file.GetKeepReader();
+    for (size_t i = 0; i < size; ++i) {
+        ASSERT_TRUE(fr.HasNext());
+        ASSERT_EQ(i, fr.Next<unsigned>());
+    }
+    ASSERT_TRUE(!fr.HasNext());
+}
+
+TEST_F(File, EvictSequentialTailFirst) {
+    // more than can be evicted together into one extent
+    static constexpr size_t size = 24 * 1024 * 1024 / sizeof(unsigned);
+
+    data::File file(block_pool_, 0, /* dia_id */ 0);
+    file.SetEvictionHint(data::EvictionHint::ReadSequential);
+    {
+        data::File::Writer fw = file.GetWriter();
+        for (unsigned i = 0; i < size; ++i) {
+            fw.Put<unsigned>(i);
+        }
+    }
+    ASSERT_EQ(file.num_blocks(), block_pool_.unpinned_blocks());
+
+    // the File is read from the front, hence the last blocks are evicted
+    // instead of the least recently used first one.
+    block_pool_.EvictBlockLRU();
+    while (block_pool_.writing_blocks() != 0)
+        std::this_thread::yield();
+
+    ASSERT_LT(0u, block_pool_.unpinned_blocks());
+    ASSERT_LT(0u, block_pool_.swapped_blocks());
+    ASSERT_TRUE(file.block(0).byte_block()->in_memory());
+    ASSERT_FALSE(file.block(file.num_blocks() - 1).byte_block()->in_memory());
+
+    // read items back from EM
+    data::File::KeepReader fr = file.GetKeepReader();
+    for (size_t i = 0; i < size; ++i) {
+        ASSERT_TRUE(fr.HasNext());
+        ASSERT_EQ(i, fr.Next<unsigned>());
+    }
+    ASSERT_TRUE(!fr.HasNext());
+}
+
 TEST_F(File, RandomGetIndexOf) {
     static constexpr size_t size = 500;
 
@@ -13,6 +13,7 @@
 #define THRILL_TESTS_NET_FLOW_CONTROL_TEST_BASE_HEADER
 
 #include <gtest/gtest.h>
+#include <thrill/common/math.hpp>
 #include <thrill/net/dispatcher.hpp>
 #include <thrill/net/flow_control_channel.hpp>
 #include <thrill/net/flow_control_manager.hpp>
@@ -143,6 +144,29 @@ static void TestMultiThreadBroadcast(net::Group* net) {
         });
 }
 
+/*!
+ * Broadcasts a pointer to a host-local object from each local worker.
+ */
+static void TestMultiThreadLocalBroadcast(net::Group* net) {
+    const size_t count = 4;
+    ExecuteMultiThreads(
+        net, count, [=](net::FlowControlChannel& channel) {
+
+            size_t local_id = channel.my_rank() % count;
+
+            for (size_t origin = 0; origin < count; ++origin) {
+
+                size_t object = 42 + local_id;
+                const size_t* ptr = channel.LocalBroadcast(&object, origin);
+
+                ASSERT_EQ(42 + origin, *ptr);
+
+                // wait until all local workers have read the origin's object
+                channel.LocalBarrier();
+            }
+        });
+}
+
 /*!
  * Calculates a sum over all worker and thread ids.
  */
@@ -208,6 +232,59 @@ static void TestMultiThreadAllReduce(net::Group* net) {
         });
 }
 
+/*!
+ * Calculates an element-wise sum of vectors over all worker and thread ids.
+ */
+static void TestMultiThreadAllReduceVector(net::Group* net) {
+
+    const size_t count = 4;
+    const size_t size = 1000;
+
+    ExecuteMultiThreads(
+        net, count, [=](net::FlowControlChannel& channel) {
+            const size_t num_workers = channel.num_workers();
+
+            std::vector<size_t> values(size);
+            for (size_t i = 0; i < size; ++i)
+                values[i] = i * (channel.my_rank() + 1);
+
+            std::vector<size_t> res = channel.AllReduceVector(values);
+
+            ASSERT_EQ(size, res.size());
+            for (size_t i = 0; i < size; ++i)
+                ASSERT_EQ(i * num_workers * (num_workers + 1) / 2, res[i]);
+        });
+}
+
+/*!
+ * Calculates an element-wise sum of vectors over all worker and thread ids and
+ * scatters the result.
+ */
+static void TestMultiThreadReduceScatter(net::Group* net) {
+
+    const size_t count = 4;
+    const size_t size = 1000;
+
+    ExecuteMultiThreads(
+        net, count, [=](net::FlowControlChannel& channel) {
+            const size_t num_workers = channel.num_workers();
+
+            std::vector<size_t> values(size);
+            for (size_t i = 0; i < size; ++i)
+                values[i] = i * (channel.my_rank() + 1);
+
+            std::vector<size_t> res = channel.ReduceScatter(values);
+
+            common::Range range = common::CalculateLocalRange(
+                size, num_workers, channel.my_rank());
+            ASSERT_EQ(range.size(), res.size());
+            for (size_t i = 0; i < res.size(); ++i) {
+                size_t index = range.begin + i;
+                ASSERT_EQ(index * num_workers * (num_workers + 1) / 2, res[i]);
+            }
+        });
+}
+
 /*!
  * Calculates a sum over all worker and thread ids.
  */
@@ -202,6 +202,40 @@ static void TestAllReduceHypercubeString(net::Group* net) {
     ASSERT_EQ(result.substr(0, net->num_hosts()), local_value);
 }
 
+//! let group of p hosts perform a ReduceScatter of an array of integers
+static void TestReduceScatterArray(net::Group* net) {
+    const size_t num_hosts = net->num_hosts();
+    const size_t size = 1000;
+
+    std::vector<size_t> values(size);
+    for (size_t i = 0; i < size; ++i)
+        values[i] = i * (net->my_host_rank() + 1);
+
+    net->ReduceScatter(values.data(), values.size());
+
+    common::Range range =
+        common::CalculateLocalRange(size, num_hosts, net->my_host_rank());
+    for (size_t i = range.begin; i < range.end; ++i)
+        ASSERT_EQ(i * num_hosts * (num_hosts + 1) / 2, values[i]);
+}
+
+//! let group of p hosts perform an AllReduce of arrays of integers, also with
+//! fewer items than hosts.
+static void TestAllReduceArray(net::Group* net) {
+    const size_t num_hosts = net->num_hosts();
+
+    for (size_t size : { size_t(0), size_t(3), size_t(1000) }) {
+        std::vector<size_t> values(size);
+        for (size_t i = 0; i < size; ++i)
+            values[i] = i * (net->my_host_rank() + 1);
+
+        net->AllReduceArray(values.data(), values.size());
+
+        for (size_t i = 0; i < size; ++i)
+            ASSERT_EQ(i * num_hosts * (num_hosts + 1) / 2, values[i]);
+    }
+}
+
 /******************************************************************************/
 // Dispatcher Tests
 
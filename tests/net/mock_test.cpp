@@ -91,6 +91,12 @@ TEST(MockGroup, AllReduceString) {
 TEST(MockGroup, AllReduceHypercubeString) {
     MockTest(TestAllReduceHypercubeString);
 }
+TEST(MockGroup, ReduceScatterArray) {
+    MockTest(TestReduceScatterArray);
+}
+TEST(MockGroup, AllReduceArray) {
+    MockTest(TestAllReduceArray);
+}
 TEST(MockGroup, DispatcherSyncSendAsyncRead) {
     MockTest(TestDispatcherSyncSendAsyncRead);
 }
@@ -109,6 +115,9 @@ TEST(MockGroup, SingleThreadBroadcast) {
 TEST(MockGroup, MultiThreadBroadcast) {
     MockTestLess(TestMultiThreadBroadcast);
 }
+TEST(MockGroup, MultiThreadLocalBroadcast) {
+    MockTestLess(TestMultiThreadLocalBroadcast);
+}
 TEST(MockGroup, MultiThreadReduce) {
     MockTestLess(TestMultiThreadReduce);
 }
@@ -118,6 +127,12 @@ TEST(MockGroup, SingleThreadAllReduce) {
 TEST(MockGroup, MultiThreadAllReduce) {
     MockTestLess(TestMultiThreadAllReduce);
 }
+TEST(MockGroup, MultiThreadAllReduceVector) {
+    MockTestLess(TestMultiThreadAllReduceVector);
+}
+TEST(MockGroup, MultiThreadReduceScatter) {
+    MockTestLess(TestMultiThreadReduceScatter);
+}
 TEST(MockGroup, MultiThreadPrefixSum) {
     MockTestLess(TestMultiThreadPrefixSum);
 }
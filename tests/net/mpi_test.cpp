@@ -93,6 +93,12 @@ TEST(MpiGroup, AllReduceString) {
 TEST(MpiGroup, AllReduceHypercubeString) {
     MpiTest(TestAllReduceHypercubeString);
 }
+TEST(MpiGroup, ReduceScatterArray) {
+    MpiTest(TestReduceScatterArray);
+}
+TEST(MpiGroup, AllReduceArray) {
+    MpiTest(TestAllReduceArray);
+}
 TEST(MpiGroup, DispatcherSyncSendAsyncRead) {
     MpiTest(TestDispatcherSyncSendAsyncRead);
 }
@@ -111,6 +117,9 @@ TEST(MpiGroup, SingleThreadBroadcast) {
 TEST(MpiGroup, MultiThreadBroadcast) {
     MpiTest(TestMultiThreadBroadcast);
 }
+TEST(MpiGroup, MultiThreadLocalBroadcast) {
+    MpiTest(TestMultiThreadLocalBroadcast);
+}
 TEST(MpiGroup, MultiThreadReduce) {
     MpiTest(TestMultiThreadReduce);
 }
@@ -120,6 +129,12 @@ TEST(MpiGroup, SingleThreadAllReduce) {
 TEST(MpiGroup, MultiThreadAllReduce) {
     MpiTest(TestMultiThreadAllReduce);
 }
+TEST(MpiGroup, MultiThreadAllReduceVector) {
+    MpiTest(TestMultiThreadAllReduceVector);
+}
+TEST(MpiGroup, MultiThreadReduceScatter) {
+    MpiTest(TestMultiThreadReduceScatter);
+}
 TEST(MpiGroup, MultiThreadPrefixSum) {
     MpiTest(TestMultiThreadPrefixSum);
 }
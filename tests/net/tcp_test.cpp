@@ -83,6 +83,12 @@ TEST(RealTcpGroup, AllReduceString) {
 TEST(RealTcpGroup, AllReduceHypercubeString) {
     RealGroupTest(TestAllReduceHypercubeString);
 }
+TEST(RealTcpGroup, ReduceScatterArray) {
+    RealGroupTest(TestReduceScatterArray);
+}
+TEST(RealTcpGroup, AllReduceArray) {
+    RealGroupTest(TestAllReduceArray);
+}
 TEST(RealTcpGroup, DispatcherSyncSendAsyncRead) {
     RealGroupTest(TestDispatcherSyncSendAsyncRead);
 }
@@ -125,6 +131,12 @@ TEST(LocalTcpGroup, AllReduceString) {
 TEST(LocalTcpGroup, AllReduceHypercubeString) {
     LocalGroupTest(TestAllReduceHypercubeString);
 }
+TEST(LocalTcpGroup, ReduceScatterArray) {
+    LocalGroupTest(TestReduceScatterArray);
+}
+TEST(LocalTcpGroup, AllReduceArray) {
+    LocalGroupTest(TestAllReduceArray);
+}
 TEST(LocalTcpGroup, DispatcherSyncSendAsyncRead) {
     LocalGroupTest(TestDispatcherSyncSendAsyncRead);
 }
@@ -143,6 +155,9 @@ TEST(LocalTcpGroup, SingleThreadBroadcast) {
 TEST(LocalTcpGroup, MultiThreadBroadcast) {
     LocalGroupTest(TestMultiThreadBroadcast);
 }
+TEST(LocalTcpGroup, MultiThreadLocalBroadcast) {
+    LocalGroupTest(TestMultiThreadLocalBroadcast);
+}
 TEST(LocalTcpGroup, MultiThreadReduce) {
     LocalGroupTest(TestMultiThreadReduce);
 }
@@ -152,6 +167,12 @@ TEST(LocalTcpGroup, SingleThreadAllReduce) {
 TEST(LocalTcpGroup, MultiThreadAllReduce) {
     LocalGroupTest(TestMultiThreadAllReduce);
 }
+TEST(LocalTcpGroup, MultiThreadAllReduceVector) {
+    LocalGroupTest(TestMultiThreadAllReduceVector);
+}
+TEST(LocalTcpGroup, MultiThreadReduceScatter) {
+    LocalGroupTest(TestMultiThreadReduceScatter);
+}
 TEST(LocalTcpGroup, MultiThreadPrefixSum) {
     LocalGroupTest(TestMultiThreadPrefixSum);
 }
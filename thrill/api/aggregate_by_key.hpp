@@ -0,0 +1,329 @@
+/*******************************************************************************
+ * thrill/api/aggregate_by_key.hpp
+ *
+ * DIANode for an aggregate operation. Performs partial aggregation into an
+ * accumulator type which may differ from the item type.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_API_AGGREGATE_BY_KEY_HEADER
+#define THRILL_API_AGGREGATE_BY_KEY_HEADER
+
+#include <thrill/api/dia.hpp>
+#include <thrill/api/dop_node.hpp>
+#include <thrill/api/reduce_by_key.hpp>
+#include <thrill/common/functional.hpp>
+#include <thrill/common/logger.hpp>
+#include <thrill/common/porting.hpp>
+#include <thrill/core/reduce_by_hash_post_stage.hpp>
+#include <thrill/core/reduce_pre_stage.hpp>
+
+#include <functional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace thrill {
+namespace api {
+
+/*!
+ * A DIANode which performs an AggregateByKey operation. Each item is added
+ * with the add_function to the accumulator of its key in the pre stage's
+ * table, or to a copy of the initial accumulator if the key is not in the
+ * table, and accumulators with the same key are combined with the
+ * merge_function. Hence, the pre stage reduces the items locally into partial
+ * aggregates, and only these are transmitted to the post stage on the key's
+ * worker. After complete reduction, the finish_function maps each key and its
+ * accumulator to an output item.
+ *
+ * Internally, the node runs the same ReducePreStage and ReduceByHashPostStage
+ * as ReduceByKey, but on std::pair<Key, Accumulator>.
+ *
+ * \tparam ValueType Output type of the AggregateByKey operation
+ * \tparam ParentDIA Type of the parent DIA.
+ * \tparam KeyExtractor Type of the key_extractor function.
+ * \tparam Accumulator Type of the partial aggregates.
+ * \tparam AddFunction Type of the add_function: (Accumulator, Item) ->
+ * Accumulator.
+ * \tparam MergeFunction Type of the merge_function: (Accumulator, Accumulator)
+ * -> Accumulator.
+ * \tparam FinishFunction Type of the finish_function: (Key, Accumulator) ->
+ * ValueType.
+ *
+ * \ingroup api_layer
+ */
+template <typename ValueType, typename ParentDIA,
+          typename KeyExtractor, typename Accumulator,
+          typename AddFunction, typename MergeFunction,
+          typename FinishFunction, typename ReduceConfig>
+class AggregateByKeyNode final : public DOpNode<ValueType>
+{
+    static constexpr bool debug = false;
+
+    using Super = DOpNode<ValueType>;
+    using Super::context_;
+
+    using Key = typename common::FunctionTraits<KeyExtractor>::result_type;
+    using ValueIn =
+              typename common::FunctionTraits<KeyExtractor>::template arg_plain<0>;
+    using KeyAccPair = std::pair<Key, Accumulator>;
+
+    //! dummy key extractor for the tables, which only receive key/accumulator
+    //! pairs and hence never need to extract a key.
+    using AccKeyExtractor = std::function<Key(const Accumulator&)>;
+
+    static constexpr bool use_mix_stream_ = ReduceConfig::use_mix_stream_;
+    static constexpr bool use_post_thread_ = ReduceConfig::use_post_thread_;
+
+private:
+    //! Emitter for PostStage to finish accumulators and push results to the
+    //! next DIA object.
+    class Emitter
+    {
+    public:
+        explicit Emitter(AggregateByKeyNode* node) : node_(node) { }
+        void operator () (const KeyAccPair& p) const {
+            return node_->PushItem(node_->finish_function_(p.first, p.second));
+        }
+
+    private:
+        AggregateByKeyNode* node_;
+    };
+
+public:
+    /*!
+     * Constructor for an AggregateByKeyNode. Sets the parent, stack and the
+     * aggregation UDFs.
+     */
+    AggregateByKeyNode(const ParentDIA& parent,
+                       const KeyExtractor& key_extractor,
+                       const Accumulator& initial_accumulator,
+                       const AddFunction& add_function,
+                       const MergeFunction& merge_function,
+                       const FinishFunction& finish_function,
+                       const ReduceConfig& config)
+        : Super(parent.ctx(), "AggregateByKey",
+                { parent.id() }, { parent.node() }),
+          key_extractor_(key_extractor),
+          initial_accumulator_(initial_accumulator),
+          add_function_(add_function),
+          finish_function_(finish_function),
+          mix_stream_(use_mix_stream_ ?
+                      parent.ctx().GetNewMixStream(this) : nullptr),
+          cat_stream_(use_mix_stream_ ?
+                      nullptr : parent.ctx().GetNewCatStream(this)),
+          emitters_(use_mix_stream_ ?
+                    mix_stream_->GetWriters() : cat_stream_->GetWriters()),
+          pre_stage_(
+              context_, Super::id(), parent.ctx().num_workers(),
+              AccKeyExtractor(NoKeyExtractor), merge_function, emitters_,
+              config),
+          post_stage_(
+              context_, Super::id(), AccKeyExtractor(NoKeyExtractor),
+              merge_function, Emitter(this), config)
+    {
+        // Hook PreOp: add each item to the accumulator of its key in the pre
+        // stage.
+        auto pre_op_fn = [this](const ValueIn& input) {
+                             return PreOp(input);
+                         };
+        // close the function stack with our pre op and register it at
+        // parent node for output
+        auto lop_chain = parent.stack().push(pre_op_fn).fold();
+        parent.node()->AddChild(this, lop_chain);
+    }
+
+    //! Add the item to the accumulator of its key in the pre stage table. Only
+    //! if the key is not in the table, the item is inserted as a singleton
+    //! accumulator, which goes through the table's insert and spill path.
+    void PreOp(const ValueIn& input) {
+        Key key = key_extractor_(input);
+        Accumulator* acc =
+            mem::memory_exceeded ? nullptr : pre_stage_.Find(key);
+        if (acc) {
+            *acc = add_function_(std::move(*acc), input);
+            return;
+        }
+        pre_stage_.Insert(
+            KeyAccPair(std::move(key),
+                       add_function_(initial_accumulator_, input)));
+    }
+
+    DIAMemUse PreOpMemUse() final {
+        // request maximum RAM limit, the value is calculated by StageBuilder,
+        // and set as DIABase::mem_limit_.
+        return DIAMemUse::Max();
+    }
+
+    void StartPreOp(size_t /* id */) final {
+        LOG << *this << " running StartPreOp";
+        if (!use_post_thread_) {
+            // use pre_stage without extra thread
+            pre_stage_.Initialize(DIABase::mem_limit_);
+        }
+        else {
+            pre_stage_.Initialize(DIABase::mem_limit_ / 2);
+            post_stage_.Initialize(DIABase::mem_limit_ / 2);
+
+            // start additional thread to receive from the channel
+            thread_ = common::CreateThread([this] { ProcessChannel(); });
+        }
+    }
+
+    void StopPreOp(size_t /* id */) final {
+        LOG << *this << " running StopPreOp";
+        // Flush hash table before the postOp
+        pre_stage_.FlushAll();
+        pre_stage_.CloseAll();
+        // waiting for the additional thread to finish the reduce
+        if (use_post_thread_) thread_.join();
+        use_mix_stream_ ? mix_stream_->Close() : cat_stream_->Close();
+    }
+
+    void Execute() final { }
+
+    DIAMemUse PushDataMemUse() final {
+        return DIAMemUse::Max();
+    }
+
+    void PushData(bool consume) final {
+
+        if (!use_post_thread_ && !reduced_) {
+            // not final reduced, and no additional thread, perform post reduce
+            post_stage_.Initialize(DIABase::mem_limit_);
+            ProcessChannel();
+
+            reduced_ = true;
+        }
+        post_stage_.PushData(consume);
+    }
+
+    //! process the inbound partial aggregates in the post reduce stage
+    void ProcessChannel() {
+        if (use_mix_stream_)
+        {
+            auto reader = mix_stream_->GetMixReader(/* consume */ true);
+            while (reader.HasNext()) {
+                post_stage_.Insert(reader.template Next<KeyAccPair>());
+            }
+        }
+        else
+        {
+            auto reader = cat_stream_->GetCatReader(/* consume */ true);
+            while (reader.HasNext()) {
+                post_stage_.Insert(reader.template Next<KeyAccPair>());
+            }
+        }
+    }
+
+    void Dispose() final {
+        post_stage_.Dispose();
+    }
+
+private:
+    //! Key extractor function
+    KeyExtractor key_extractor_;
+
+    //! Initial accumulator, copied for each item
+    Accumulator initial_accumulator_;
+
+    //! Add function folding an item into an accumulator
+    AddFunction add_function_;
+
+    //! Finish function mapping key and accumulator to an output item
+    FinishFunction finish_function_;
+
+    // pointers for both Mix and CatStream. only one is used, the other costs
+    // only a null pointer.
+    data::MixStreamPtr mix_stream_;
+    data::CatStreamPtr cat_stream_;
+
+    std::vector<data::Stream::Writer> emitters_;
+
+    //! handle to additional thread for post stage
+    std::thread thread_;
+
+    core::ReducePreStage<
+        Accumulator, Key, Accumulator, AccKeyExtractor, MergeFunction,
+        /* VolatileKey */ true, ReduceConfig> pre_stage_;
+
+    core::ReduceByHashPostStage<
+        KeyAccPair, Key, Accumulator, AccKeyExtractor, MergeFunction, Emitter,
+        /* SendPair */ true, ReduceConfig> post_stage_;
+
+    bool reduced_ = false;
+
+    //! The tables receive only key/accumulator pairs, this function should
+    //! never be called.
+    static Key NoKeyExtractor(const Accumulator&) {
+        assert(!"AggregateByKeyNode must not extract keys from accumulators");
+        return Key();
+    }
+};
+
+template <typename ValueType, typename Stack>
+template <typename KeyExtractor, typename Accumulator,
+          typename AddFunction, typename MergeFunction,
+          typename FinishFunction, typename ReduceConfig>
+auto DIA<ValueType, Stack>::AggregateByKey(
+    const KeyExtractor &key_extractor,
+    const Accumulator &initial_accumulator,
+    const AddFunction &add_function,
+    const MergeFunction &merge_function,
+    const FinishFunction &finish_function,
+    const ReduceConfig &reduce_config) const {
+    assert(IsValid());
+
+    using DOpResult
+              = typename common::FunctionTraits<FinishFunction>::result_type;
+
+    static_assert(
+        std::is_same<
+            typename std::decay<typename common::FunctionTraits<KeyExtractor>
+                                ::template arg<0> >::type,
+            ValueType>::value,
+        "KeyExtractor has the wrong input type");
+
+    static_assert(
+        std::is_convertible<
+            ValueType,
+            typename common::FunctionTraits<AddFunction>::template arg<1>
+            >::value,
+        "AddFunction has the wrong input type");
+
+    static_assert(
+        std::is_convertible<
+            typename common::FunctionTraits<AddFunction>::result_type,
+            Accumulator>::value,
+        "AddFunction has the wrong output type");
+
+    static_assert(
+        std::is_convertible<
+            typename common::FunctionTraits<MergeFunction>::result_type,
+            Accumulator>::value,
+        "MergeFunction has the wrong output type");
+
+    using AggregateByKeyNode = api::AggregateByKeyNode<
+              DOpResult, DIA, KeyExtractor, Accumulator,
+              AddFunction, MergeFunction, FinishFunction, ReduceConfig>;
+
+    auto node = common::MakeCounting<AggregateByKeyNode>(
+        *this, key_extractor, initial_accumulator,
+        add_function, merge_function, finish_function, reduce_config);
+
+    return DIA<DOpResult>(node);
+}
+
+} // namespace api
+} // namespace thrill
+
+#endif // !THRILL_API_AGGREGATE_BY_KEY_HEADER
+
+/******************************************************************************/
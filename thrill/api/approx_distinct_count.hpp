@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * thrill/api/approx_distinct_count.hpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_API_APPROX_DISTINCT_COUNT_HEADER
+#define THRILL_API_APPROX_DISTINCT_COUNT_HEADER
+
+#include <thrill/api/action_node.hpp>
+#include <thrill/api/dia.hpp>
+#include <thrill/core/hyperloglog.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace thrill {
+namespace api {
+
+/*!
+ * ActionNode which estimates the number of distinct items in a DIA using a
+ * HyperLogLog sketch. Each worker inserts its items into local registers, which
+ * are then combined with a single vector AllReduce of 2^precision bytes.
+ *
+ * \ingroup api_layer
+ */
+template <typename ParentDIA, typename HashFunction>
+class ApproxDistinctCountNode final : public ActionNode
+{
+    static constexpr bool debug = false;
+
+    using Super = ActionNode;
+    using Super::context_;
+
+    //! input type is the parent's output value type.
+    using ValueType = typename ParentDIA::ValueType;
+
+public:
+    ApproxDistinctCountNode(const ParentDIA& parent, size_t precision,
+                            const HashFunction& hash_function)
+        : ActionNode(parent.ctx(), "ApproxDistinctCount",
+                     { parent.id() }, { parent.node() }),
+          hash_function_(hash_function),
+          registers_(precision)
+    {
+        // Hook PreOp(s)
+        auto pre_op_fn = [this](const ValueType& input) {
+                             registers_.Insert(input, hash_function_);
+                         };
+
+        auto lop_chain = parent.stack().push(pre_op_fn).fold();
+        parent.node()->AddChild(this, lop_chain);
+    }
+
+    //! Executes the register merge.
+    void Execute() final {
+        registers_.registers() = context_.net.AllReduceVector(
+            registers_.registers(),
+            [](const uint8_t& a, const uint8_t& b) { return std::max(a, b); });
+        estimate_ = registers_.Estimate();
+
+        LOG << "ApproxDistinctCount estimate=" << estimate_;
+    }
+
+    //! Returns the global estimate.
+    size_t result() const {
+        return static_cast<size_t>(std::llround(estimate_));
+    }
+
+private:
+    //! hash function applied to items
+    HashFunction hash_function_;
+    //! local, later global HyperLogLog registers
+    core::HyperLogLogRegisters registers_;
+    //! result of the estimate
+    double estimate_ = 0.0;
+};
+
+template <typename ValueType, typename Stack>
+template <typename HashFunction>
+size_t DIA<ValueType, Stack>::ApproxDistinctCount(
+    size_t precision, const HashFunction& hash_function) const {
+    assert(IsValid());
+
+    if (precision < core::HyperLogLogRegisters::min_precision ||
+        precision > core::HyperLogLogRegisters::max_precision) {
+        throw std::invalid_argument(
+                  "ApproxDistinctCount: precision must be between "
+                  + std::to_string(core::HyperLogLogRegisters::min_precision)
+                  + " and "
+                  + std::to_string(core::HyperLogLogRegisters::max_precision));
+    }
+
+    using ApproxDistinctCountNode =
+              api::ApproxDistinctCountNode<DIA, HashFunction>;
+
+    auto node = common::MakeCounting<ApproxDistinctCountNode>(
+        *this, precision, hash_function);
+
+    node->RunScope();
+
+    return node->result();
+}
+
+} // namespace api
+} // namespace thrill
+
+#endif // !THRILL_API_APPROX_DISTINCT_COUNT_HEADER
+
+/******************************************************************************/
@@ -0,0 +1,285 @@
+/*******************************************************************************
+ * thrill/api/broadcast_join.hpp
+ *
+ * DIANode for a broadcast join, which joins a large DIA against a small one by
+ * replicating the small DIA to all hosts.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_API_BROADCAST_JOIN_HEADER
+#define THRILL_API_BROADCAST_JOIN_HEADER
+
+#include <thrill/api/dia.hpp>
+#include <thrill/api/dop_node.hpp>
+#include <thrill/common/functional.hpp>
+#include <thrill/common/logger.hpp>
+#include <thrill/data/file.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace thrill {
+namespace api {
+
+/*!
+ * A DIANode which performs an inner join of a large DIA with a small DIA
+ * without shuffling the large one. All items of the small DIA are sent to the
+ * first local worker of every host, which builds a read-only hash index. The
+ * index is then shared with all other workers on the host via a pointer, hence
+ * there is only one copy per host. The large DIA is stored locally and in
+ * PushData() each item is looked up in the index and joined with all matching
+ * items of the small DIA.
+ *
+ * The small DIA must fit into the RAM of each host: the index is built within
+ * the memory limits of all workers of the host, and the join throws a
+ * std::runtime_error on all workers if it does not fit.
+ *
+ * \tparam ValueType Output type of the BroadcastJoin operation.
+ * \tparam ParentDIA0 Type of the large input DIA.
+ * \tparam ParentDIA1 Type of the small input DIA, which is replicated.
+ *
+ * \ingroup api_layer
+ */
+template <typename ValueType, typename ParentDIA0, typename ParentDIA1,
+          typename KeyExtractor0, typename KeyExtractor1,
+          typename JoinFunction, typename HashFunction>
+class BroadcastJoinNode final : public DOpNode<ValueType>
+{
+    static constexpr bool debug = false;
+
+    using Super = DOpNode<ValueType>;
+    using Super::context_;
+
+    using LargeType =
+              typename common::FunctionTraits<KeyExtractor0>::template arg_plain<0>;
+    using SmallType =
+              typename common::FunctionTraits<KeyExtractor1>::template arg_plain<0>;
+    using Key = typename common::FunctionTraits<KeyExtractor0>::result_type;
+
+    //! read-only hash index of the small DIA, shared by all local workers
+    using Index = std::unordered_multimap<Key, SmallType, HashFunction>;
+
+public:
+    BroadcastJoinNode(const ParentDIA0& parent0, const ParentDIA1& parent1,
+                      const KeyExtractor0& key_extractor0,
+                      const KeyExtractor1& key_extractor1,
+                      const JoinFunction& join_function,
+                      const HashFunction& hash_function)
+        : Super(parent0.ctx(), "BroadcastJoin",
+                { parent0.id(), parent1.id() },
+                { parent0.node(), parent1.node() }),
+          key_extractor0_(key_extractor0),
+          key_extractor1_(key_extractor1),
+          join_function_(join_function),
+          hash_function_(hash_function)
+    {
+        // Hook PreOp of the large DIA: store items locally
+        auto pre_op0_fn = [this](const LargeType& input) {
+                              large_writer_.Put(input);
+                          };
+        auto lop_chain0 = parent0.stack().push(pre_op0_fn).fold();
+        parent0.node()->AddChild(this, lop_chain0, 0);
+
+        // Hook PreOp of the small DIA: send items to all hosts
+        auto pre_op1_fn = [this](const SmallType& input) {
+                              PreOpSmall(input);
+                          };
+        auto lop_chain1 = parent1.stack().push(pre_op1_fn).fold();
+        parent1.node()->AddChild(this, lop_chain1, 1);
+    }
+
+    void StartPreOp(size_t parent_index) final {
+        if (parent_index == 0)
+            large_writer_ = large_file_.GetWriter();
+        else
+            small_emitters_ = small_stream_->GetWriters();
+    }
+
+    //! Receive a whole data::File of the large DIA, but only if its stack is
+    //! empty.
+    bool OnPreOpFile(const data::File& file, size_t parent_index) final {
+        if (parent_index != 0 || !ParentDIA0::stack_empty) return false;
+        assert(large_file_.num_items() == 0);
+        large_file_ = file.Copy();
+        return true;
+    }
+
+    //! Send an item of the small DIA to the first worker of each host.
+    void PreOpSmall(const SmallType& input) {
+        const size_t workers_per_host = context_.workers_per_host();
+        for (size_t h = 0; h < context_.num_hosts(); ++h)
+            small_emitters_[h * workers_per_host].Put(input);
+    }
+
+    void StopPreOp(size_t parent_index) final {
+        if (parent_index == 0) {
+            large_writer_.Close();
+        }
+        else {
+            for (size_t i = 0; i < small_emitters_.size(); i++)
+                small_emitters_[i].Close();
+        }
+    }
+
+    DIAMemUse ExecuteMemUse() final {
+        return DIAMemUse::Max();
+    }
+
+    void Execute() final {
+        MainOp();
+    }
+
+    DIAMemUse PushDataMemUse() final {
+        // the index is kept until Dispose()
+        return DIAMemUse::Max();
+    }
+
+    void PushData(bool consume) final {
+        size_t result_count = 0;
+
+        auto reader = large_file_.GetReader(consume);
+        while (reader.HasNext()) {
+            LargeType item = reader.template Next<LargeType>();
+            auto range = index_->equal_range(key_extractor0_(item));
+            for (auto it = range.first; it != range.second; ++it) {
+                this->PushItem(join_function_(item, it->second));
+                ++result_count;
+            }
+        }
+
+        LOG << "BroadcastJoin: result_count " << result_count;
+    }
+
+    void Dispose() final {
+        large_file_.Clear();
+        index_.reset();
+    }
+
+private:
+    KeyExtractor0 key_extractor0_;
+    KeyExtractor1 key_extractor1_;
+    JoinFunction join_function_;
+    HashFunction hash_function_;
+
+    //! File containing the local items of the large DIA
+    data::File large_file_ { context_.GetFile(this) };
+    data::File::Writer large_writer_;
+
+    //! CatStream to replicate the small DIA on the first worker of each host
+    data::CatStreamPtr small_stream_ { context_.GetNewCatStream(this) };
+    std::vector<data::Stream::Writer> small_emitters_;
+
+    //! shared hash index of the small DIA, owned by all local workers.
+    std::shared_ptr<const Index> index_;
+
+    //! estimated bytes of an index entry: the node with key, item, next
+    //! pointer and cached hash, and a bucket pointer.
+    static constexpr size_t index_entry_bytes_ =
+        sizeof(typename Index::value_type) + 3 * sizeof(void*);
+
+    //! Build the hash index on the first local worker and share it.
+    void MainOp() {
+        // the index is shared by the host's workers, hence it may use their
+        // memory limits.
+        const size_t limit_bytes =
+            DIABase::mem_limit_ * context_.workers_per_host();
+        size_t index_bytes = 0;
+        bool too_large = false;
+
+        std::shared_ptr<Index> index;
+        if (context_.local_worker_id() == 0)
+            index = std::make_shared<Index>(0, hash_function_);
+
+        auto reader = small_stream_->GetCatReader(/* consume */ true);
+        while (reader.HasNext()) {
+            SmallType item = reader.template Next<SmallType>();
+            if (too_large) continue;
+            assert(index);
+
+            index_bytes += index_entry_bytes_;
+            if (index_bytes > limit_bytes || mem::memory_exceeded) {
+                // drop the index, but receive the remaining items
+                too_large = true;
+                index.reset();
+                continue;
+            }
+            Key key = key_extractor1_(item);
+            index->emplace(std::move(key), std::move(item));
+        }
+        small_stream_->Close();
+
+        if (context_.net.AllReduce(static_cast<size_t>(too_large)) != 0) {
+            throw std::runtime_error(
+                      "BroadcastJoin: the small DIA does not fit into the "
+                      "memory limit of a host");
+        }
+
+        index_ = context_.net.LocalBroadcast(
+            std::shared_ptr<const Index>(index));
+
+        LOG << "BroadcastJoin: index contains " << index_->size() << " items";
+    }
+};
+
+template <typename ValueType, typename Stack>
+template <typename KeyExtractor0, typename KeyExtractor1,
+          typename JoinFunction, typename SecondDIA, typename HashFunction>
+auto DIA<ValueType, Stack>::BroadcastJoin(
+    const SecondDIA &small_dia,
+    const KeyExtractor0 &key_extractor0,
+    const KeyExtractor1 &key_extractor1,
+    const JoinFunction &join_function,
+    const HashFunction &hash_function) const {
+    assert(IsValid());
+    assert(small_dia.IsValid());
+
+    static_assert(
+        std::is_convertible<
+            ValueType,
+            typename common::FunctionTraits<KeyExtractor0>::template arg<0>
+            >::value,
+        "KeyExtractor0 has the wrong input type");
+
+    static_assert(
+        std::is_convertible<
+            typename SecondDIA::ValueType,
+            typename common::FunctionTraits<KeyExtractor1>::template arg<0>
+            >::value,
+        "KeyExtractor1 has the wrong input type");
+
+    static_assert(
+        std::is_same<
+            typename common::FunctionTraits<KeyExtractor0>::result_type,
+            typename common::FunctionTraits<KeyExtractor1>::result_type
+            >::value,
+        "KeyExtractor0 and KeyExtractor1 must return the same key type");
+
+    using JoinResult =
+              typename common::FunctionTraits<JoinFunction>::result_type;
+
+    using BroadcastJoinNode = api::BroadcastJoinNode<
+              JoinResult, DIA, SecondDIA,
+              KeyExtractor0, KeyExtractor1, JoinFunction, HashFunction>;
+
+    auto node = common::MakeCounting<BroadcastJoinNode>(
+        *this, small_dia, key_extractor0, key_extractor1,
+        join_function, hash_function);
+
+    return DIA<JoinResult>(node);
+}
+
+} // namespace api
+} // namespace thrill
+
+#endif // !THRILL_API_BROADCAST_JOIN_HEADER
+
+/******************************************************************************/
@@ -15,8 +15,12 @@
 #include <thrill/api/collapse.hpp>
 #include <thrill/api/dia.hpp>
 #include <thrill/api/dia_node.hpp>
+#include <thrill/common/logger.hpp>
 #include <thrill/data/file.hpp>
+#include <thrill/mem/allocator.hpp>
+#include <thrill/mem/malloc_tracker.hpp>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -32,8 +36,12 @@ public:
     using Super = DIANode<ValueType>;
 
     template <typename ParentDIA>
-    explicit CacheNodeBase(const ParentDIA& parent)
-        : Super(parent.ctx(), "Cache", { parent.id() }, { parent.node() }) { }
+    explicit CacheNodeBase(const ParentDIA& parent,
+                           const char* label = "Cache")
+        : Super(parent.ctx(), label, { parent.id() }, { parent.node() }) { }
+
+    //! Returns true if the items are kept deserialized in memory.
+    virtual bool in_memory() const { return false; }
 };
 
 /*!
@@ -88,6 +96,153 @@ private:
     data::File::Writer writer_ { file_.GetWriter() };
 };
 
+/*!
+ * A DOpNode which caches all items deserialized in a std::vector, if they fit
+ * into the node's memory limit, and otherwise in an external file like
+ * CacheNode. Iterative algorithms, which push the items many times, thereby
+ * skip the deserialization.
+ *
+ * The PreOp requests a fixed fraction of the worker's memory limit. The
+ * vector's capacity, including the old buffer while growing, and the heap
+ * memory of the copied items, measured with the malloc_tracker, are counted
+ * against it. If the items stay in RAM, their memory is held in the Context
+ * until Dispose(), hence all following stages get a smaller memory limit.
+ *
+ * \ingroup api_layer
+ */
+template <typename ValueType, typename ParentDIA>
+class CacheInMemoryNode final : public CacheNodeBase<ValueType>
+{
+    static constexpr bool debug = false;
+
+public:
+    using Super = CacheNodeBase<ValueType>;
+    using Super::context_;
+
+    //! Vector type holding the items, using the node's memory accounting.
+    using Vector = std::vector<ValueType, mem::Allocator<ValueType> >;
+
+    explicit CacheInMemoryNode(const ParentDIA& parent)
+        : Super(parent, "CacheInMemory") {
+        // CacheNodes are kept by default.
+        Super::consume_counter_ = Super::never_consume_;
+
+        auto save_fn = [this](const ValueType& input) {
+                           PreOp(input);
+                       };
+        auto lop_chain = parent.stack().push(save_fn).fold();
+        parent.node()->AddChild(this, lop_chain);
+    }
+
+    bool in_memory() const final { return !spilled_; }
+
+    DIAMemUse PreOpMemUse() final {
+        return static_cast<size_t>(
+            static_cast<double>(context_.mem_limit()) * max_mem_fraction_);
+    }
+
+    //! Store item in the vector, or in the File after exceeding the limit.
+    void PreOp(const ValueType& input) {
+        if (!spilled_) {
+            if (!mem::memory_exceeded &&
+                BytesAfterPush() <= DIABase::mem_limit_) {
+                size_t before = mem::malloc_tracker_current();
+                vector_.push_back(input);
+                size_t after = mem::malloc_tracker_current();
+                // heap memory owned by the copied item
+                if (after > before) item_bytes_ += after - before;
+                return;
+            }
+            Spill();
+        }
+        writer_.Put(input);
+    }
+
+    void StopPreOp(size_t /* id */) final {
+        if (spilled_) {
+            writer_.Close();
+        }
+        else {
+            vector_.shrink_to_fit();
+            // keep the memory of the items until Dispose()
+            held_bytes_ = vector_.capacity() * sizeof(ValueType) + item_bytes_;
+            context_.HoldMemory(held_bytes_);
+        }
+
+        LOG << "CacheInMemory: " << (spilled_ ? "spilled" : "kept")
+            << " items in memory: " << vector_.size()
+            << " in file: " << file_.num_items();
+    }
+
+    void Execute() final { }
+
+    void PushData(bool consume) final {
+        if (spilled_) {
+            this->PushFile(file_, consume);
+            return;
+        }
+        for (const ValueType& item : vector_)
+            this->PushItem(item);
+        if (consume) Dispose();
+    }
+
+    void Dispose() final {
+        Vector(vector_.get_allocator()).swap(vector_);
+        item_bytes_ = 0;
+        file_.Clear();
+        if (held_bytes_) {
+            context_.ReleaseMemory(held_bytes_);
+            held_bytes_ = 0;
+        }
+    }
+
+    ~CacheInMemoryNode() {
+        if (held_bytes_) context_.ReleaseMemory(held_bytes_);
+    }
+
+private:
+    //! fraction of the worker's memory limit requested for the items
+    static constexpr double max_mem_fraction_ = 0.25;
+
+    //! Local items, if they fit into RAM.
+    Vector vector_ { mem::Allocator<ValueType>(this->mem_manager()) };
+
+    //! heap memory owned by the items in vector_
+    size_t item_bytes_ = 0;
+
+    //! memory held in the Context for the items after the PreOp
+    size_t held_bytes_ = 0;
+
+    //! whether the items exceeded the limit and were moved to file_.
+    bool spilled_ = false;
+
+    //! Local data file, only used if the items were spilled.
+    data::File file_ { context_.GetFile(this) };
+    //! Data writer to local file (only active in PreOp).
+    data::File::Writer writer_;
+
+    //! Move all items from the vector into the File and continue there.
+    void Spill() {
+        LOG << "CacheInMemory: items exceed memory limit, spilling "
+            << vector_.size() << " items";
+        spilled_ = true;
+        writer_ = file_.GetWriter();
+        for (const ValueType& item : vector_)
+            writer_.Put(item);
+        Vector(vector_.get_allocator()).swap(vector_);
+        item_bytes_ = 0;
+    }
+
+    //! Bytes of the items after adding one more: the vector's capacity, plus
+    //! the old buffer if the vector has to grow, and the items' heap memory.
+    size_t BytesAfterPush() const {
+        size_t capacity = vector_.capacity();
+        if (vector_.size() == capacity)
+            capacity += std::max<size_t>(2 * capacity, 1);
+        return capacity * sizeof(ValueType) + item_bytes_;
+    }
+};
+
 template <typename ValueType, typename Stack>
 DIA<ValueType> DIA<ValueType, Stack>::Cache() const {
     assert(IsValid());
@@ -103,6 +258,22 @@ DIA<ValueType> DIA<ValueType, Stack>::Cache() const {
         common::MakeCounting<api::CacheNode<ValueType, DIA> >(*this));
 }
 
+template <typename ValueType, typename Stack>
+DIA<ValueType> DIA<ValueType, Stack>::CacheInMemory() const {
+    assert(IsValid());
+
+#if !defined(_MSC_VER)
+    // skip if this is already a CacheInMemoryNode with items in memory.
+    if (stack_empty) {
+        auto* cache = dynamic_cast<CacheNodeBase<ValueType>*>(node_.get());
+        if (cache != nullptr && cache->in_memory())
+            return *this;
+    }
+#endif
+    return DIA<ValueType>(
+        common::MakeCounting<api::CacheInMemoryNode<ValueType, DIA> >(*this));
+}
+
 } // namespace api
 } // namespace thrill
 
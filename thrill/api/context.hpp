@@ -260,8 +260,26 @@ public:
         return workers_per_host() * host_rank() + local_worker_id();
     }
 
-    //! memory limit of this worker Context for local data structures
-    size_t mem_limit() const { return mem_limit_; }
+    //! memory limit of this worker Context for local data structures,
+    //! excluding memory held across stages with HoldMemory().
+    size_t mem_limit() const { return mem_limit_ - mem_held_; }
+
+    //! Hold memory of this worker across stages, e.g. for items which a
+    //! DIANode keeps in RAM. The memory is requested from the BlockPool and
+    //! subtracted from the mem_limit() of all following stages until
+    //! ReleaseMemory() is called.
+    void HoldMemory(size_t size) {
+        assert(size <= mem_limit());
+        mem_held_ += size;
+        block_pool_.RequestInternalMemory(size);
+    }
+
+    //! Release memory held with HoldMemory().
+    void ReleaseMemory(size_t size) {
+        assert(size <= mem_held_);
+        mem_held_ -= size;
+        block_pool_.ReleaseInternalMemory(size);
+    }
 
     //! Global number of workers in the system.
     size_t num_workers() const {
@@ -387,6 +405,9 @@ private:
     //! memory limit of this worker Context for local data structures
     size_t mem_limit_;
 
+    //! memory held across stages, see HoldMemory()
+    size_t mem_held_ = 0;
+
     //! host-global memory manager
     mem::Manager& mem_manager_;
 
@@ -44,6 +44,24 @@ struct VolatileKeyTag {
 //! global const VolatileKeyTag instance
 const struct VolatileKeyTag VolatileKeyTag;
 
+//! tag structure for ReduceByKey(): range-partition the keys using sampled
+//! splitters and deliver the reduced items sorted by key.
+struct SortedKeyTag {
+    SortedKeyTag() { }
+};
+
+//! global const SortedKeyTag instance
+const struct SortedKeyTag SortedKeyTag;
+
+//! tag structure for ReduceByKey(): detect keys occurring on multiple workers
+//! via fingerprints, and shuffle only the items of these keys.
+struct DuplicateDetectionTag {
+    DuplicateDetectionTag() { }
+};
+
+//! global const DuplicateDetectionTag instance
+const struct DuplicateDetectionTag DuplicateDetectionTag;
+
 //! tag structure for Window() and FlatWindow()
 struct DisjointTag {
     DisjointTag() { }
@@ -52,6 +70,15 @@ struct DisjointTag {
 //! global const DisjointTag instance
 const struct DisjointTag DisjointTag;
 
+//! tag structure for GroupByKey(): group items in a hash table instead of
+//! sorting them, the groups are delivered in arbitrary order.
+struct HashGroupTag {
+    HashGroupTag() { }
+};
+
+//! global const HashGroupTag instance
+const struct HashGroupTag HashGroupTag;
+
 /*!
  * DIA is the interface between the user and the Thrill framework. A DIA can be
  * imagined as an immutable array, even though the data does not need to be
@@ -494,6 +521,24 @@ public:
     auto Max(const MaxFunction& max_function = MaxFunction(),
              const ValueType& initial_value = ValueType()) const;
 
+    /*!
+     * ApproxDistinctCount is an Action, which estimates the number of distinct
+     * items in the DIA using a HyperLogLog sketch. Each worker builds a local
+     * sketch of 2^precision byte registers, which are merged using a single
+     * AllReduce. The relative standard error is about 1.04 / sqrt(2^precision).
+     *
+     * \param precision Number of hash bits used to select a register, between
+     * 4 and 18. Otherwise std::invalid_argument is thrown.
+     *
+     * \param hash_function Hash function applied to the items.
+     *
+     * \ingroup dia_actions
+     */
+    template <typename HashFunction = std::hash<ValueType> >
+    size_t ApproxDistinctCount(
+        size_t precision = 14,
+        const HashFunction& hash_function = HashFunction()) const;
+
     /*!
      * WriteLines is an Action, which writes std::strings to an output file.
      * Strings are written using fstream with a newline after each entry.
@@ -614,6 +659,63 @@ public:
                      const ReduceFunction &reduce_function,
                      const ReduceConfig& reduce_config = ReduceConfig()) const;
 
+    /*!
+     * ReduceByKey is a DOp, which groups elements of the DIA with the
+     * key_extractor and reduces each key-bucket to a single element using the
+     * associative reduce_function, like ReduceBy.
+     *
+     * In contrast to ReduceBy, the keys are range-partitioned among the workers
+     * using sampled splitters, and the output DIA is sorted by key (compared
+     * with operator <). This replaces a ReduceByKey followed by a Sort by key,
+     * saving the second shuffle of the data.
+     *
+     * \param key_extractor Key extractor function, which maps each element to a
+     * key of possibly different type.
+     *
+     * \param reduce_function Reduce function, which defines how the key buckets
+     * are reduced to a single element. This function is applied associative but
+     * not necessarily commutative.
+     *
+     * \param reduce_config Reduce configuration.
+     *
+     * \ingroup dia_dops
+     */
+    template <typename KeyExtractor, typename ReduceFunction,
+              typename ReduceConfig = class DefaultReduceConfig>
+    auto ReduceByKey(struct SortedKeyTag,
+                     const KeyExtractor &key_extractor,
+                     const ReduceFunction &reduce_function,
+                     const ReduceConfig& reduce_config = ReduceConfig()) const;
+
+    /*!
+     * ReduceByKey is a DOp, which groups elements of the DIA with the
+     * key_extractor and reduces each key-bucket to a single element using the
+     * associative reduce_function, like ReduceBy.
+     *
+     * In contrast to ReduceBy, a pre-pass first exchanges compact fingerprints
+     * of the locally reduced keys to detect which keys occur on more than one
+     * worker. Only items of these keys are shuffled, all others are reduced and
+     * output on their worker. This saves network volume if most keys are
+     * globally unique.
+     *
+     * \param key_extractor Key extractor function, which maps each element to a
+     * key of possibly different type.
+     *
+     * \param reduce_function Reduce function, which defines how the key buckets
+     * are reduced to a single element. This function is applied associative but
+     * not necessarily commutative.
+     *
+     * \param reduce_config Reduce configuration.
+     *
+     * \ingroup dia_dops
+     */
+    template <typename KeyExtractor, typename ReduceFunction,
+              typename ReduceConfig = class DefaultReduceConfig>
+    auto ReduceByKey(struct DuplicateDetectionTag,
+                     const KeyExtractor &key_extractor,
+                     const ReduceFunction &reduce_function,
+                     const ReduceConfig& reduce_config = ReduceConfig()) const;
+
     /*!
      * ReducePair is a DOp, which groups key-value-pairs in the input DIA by
      * their key and reduces each key-bucket to a single element using the
@@ -641,6 +743,49 @@ public:
     auto ReducePair(const ReduceFunction &reduce_function,
                     const ReduceConfig& reduce_config = ReduceConfig()) const;
 
+    /*!
+     * AggregateByKey is a DOp, which groups elements of the DIA with the
+     * key_extractor and aggregates each key-bucket into an accumulator of
+     * possibly different type. It generalizes ReduceByKey to algebraic
+     * aggregates like mean/variance, top-N, or sketches, which cannot be
+     * expressed as a reduction of two items to one item.
+     *
+     * Each item is folded into a copy of initial_accumulator using the
+     * add_function. Accumulators of equal keys are combined locally and after
+     * the shuffle using the associative merge_function. Hence, only partial
+     * aggregates are transmitted. Finally, the finish_function maps each key
+     * and its fully merged accumulator to an output item.
+     *
+     * \param key_extractor Key extractor function, which maps each element to a
+     * key of possibly different type.
+     *
+     * \param initial_accumulator Empty accumulator value, which is copied for
+     * each item.
+     *
+     * \param add_function Function (Accumulator, ValueType) -> Accumulator,
+     * which adds an item to an accumulator.
+     *
+     * \param merge_function Associative function (Accumulator, Accumulator) ->
+     * Accumulator, which combines two partial aggregates.
+     *
+     * \param finish_function Function (Key, Accumulator) -> ValueOut, which
+     * calculates the output item from a fully merged aggregate.
+     *
+     * \param reduce_config Reduce configuration.
+     *
+     * \ingroup dia_dops
+     */
+    template <typename KeyExtractor, typename Accumulator,
+              typename AddFunction, typename MergeFunction,
+              typename FinishFunction,
+              typename ReduceConfig = class DefaultReduceConfig>
+    auto AggregateByKey(const KeyExtractor &key_extractor,
+                        const Accumulator &initial_accumulator,
+                        const AddFunction &add_function,
+                        const MergeFunction &merge_function,
+                        const FinishFunction &finish_function,
+                        const ReduceConfig& reduce_config = ReduceConfig()) const;
+
     /*!
      * ReduceToIndex is a DOp, which groups elements of the DIA with the
      * key_extractor returning an unsigned integers and reduces each key-bucket
@@ -769,6 +914,30 @@ public:
     auto GroupByKey(const KeyExtractor &key_extractor,
                     const GroupByFunction &groupby_function) const;
 
+    /*!
+     * GroupByKey is a DOp, which groups elements of the DIA by its key. This
+     * variant collects all items received by a worker in a hash table and
+     * calls the GroupByFunction for each key group directly, without sorting
+     * the items. Hence, the groups are processed in arbitrary order. If the
+     * items do not fit into RAM, the node falls back to external sorting as in
+     * the sort-based GroupByKey.
+     *
+     * \param key_extractor Key extractor function, which maps each element to a
+     * key of possibly different type.
+     *
+     * \param groupby_function Reduce function, which defines how the key
+     * buckets are grouped and processed.
+     *      input param: api::GroupByReader with functions HasNext() and Next()
+     *
+     * \ingroup dia_dops
+     */
+    template <typename ValueOut, typename KeyExtractor,
+              typename GroupByFunction, typename HashFunction =
+                  std::hash<typename FunctionTraits<KeyExtractor>::result_type> >
+    auto GroupByKey(struct HashGroupTag,
+                    const KeyExtractor &key_extractor,
+                    const GroupByFunction &groupby_function) const;
+
     /*!
      * GroupBy is a DOp, which groups elements of the DIA by its key.
      * After having grouped all elements of one key, all elements of one key
@@ -814,6 +983,53 @@ public:
                       const size_t size,
                       const ValueOut& neutral_element = ValueOut()) const;
 
+    /*!
+     * Distinct is a DOp, which removes duplicate items from the DIA. Items are
+     * deduplicated locally and then sent to the worker selected by their hash,
+     * hence items are compared using std::equal_to and hashed by the given
+     * hash_function. The output order is arbitrary.
+     *
+     * \param hash_function Hash function applied to the items.
+     *
+     * \ingroup dia_dops
+     */
+    template <typename HashFunction = std::hash<ValueType> >
+    auto Distinct(const HashFunction &hash_function = HashFunction()) const;
+
+    /*!
+     * BroadcastJoin is a DOp, which performs an inner join of this (large) DIA
+     * with a small DIA. The small DIA is replicated once per host into a
+     * read-only hash index shared by all workers of the host, and the large DIA
+     * is joined locally without any data exchange. For each pair of items with
+     * equal keys, the join_function is applied and its result is an item of the
+     * output DIA.
+     *
+     * The small DIA must fit into the RAM of each host.
+     *
+     * \param small_dia DIA, which is replicated and joined with this DIA.
+     *
+     * \param key_extractor0 Key extractor for items of this DIA.
+     *
+     * \param key_extractor1 Key extractor for items of the small DIA.
+     *
+     * \param join_function Join function applied to each pair of matching
+     * items, the first parameter is from this DIA.
+     *
+     * \param hash_function Hash function for the key type.
+     *
+     * \ingroup dia_dops
+     */
+    template <typename KeyExtractor0, typename KeyExtractor1,
+              typename JoinFunction, typename SecondDIA,
+              typename HashFunction =
+                  std::hash<typename FunctionTraits<KeyExtractor0>::result_type> >
+    auto BroadcastJoin(
+        const SecondDIA &small_dia,
+        const KeyExtractor0 &key_extractor0,
+        const KeyExtractor1 &key_extractor1,
+        const JoinFunction &join_function,
+        const HashFunction &hash_function = HashFunction()) const;
+
     /*!
      * Zip is a DOp, which Zips two DIAs in style of functional programming. The
      * zip_function is used to zip the i-th elements of both input DIAs together
@@ -972,6 +1188,31 @@ public:
      */
     DIA<ValueType> Cache() const;
 
+    /*!
+     * Create a CacheInMemoryNode which keeps all items of a DIA deserialized in
+     * a std::vector, if they fit into the worker's memory limit, and otherwise
+     * falls back to a File like Cache(). This avoids the deserialization cost
+     * in iterative algorithms which read the DIA in every iteration.
+     *
+     * \ingroup dia_dops
+     */
+    DIA<ValueType> CacheInMemory() const;
+
+    /*!
+     * Rebalance is a DOp, which redistributes the items of the DIA evenly
+     * across all workers, such that each worker holds a consecutive range of
+     * about total/p items. The order of the items is not changed. This is
+     * useful after Filter, FlatMap or ReduceByKey, which may leave the workers
+     * with very different numbers of items.
+     *
+     * \param max_imbalance If the largest worker holds at most (1 +
+     * max_imbalance) times the average number of items, then no items are
+     * transferred.
+     *
+     * \ingroup dia_dops
+     */
+    DIA<ValueType> Rebalance(double max_imbalance = 0.1) const;
+
     //! \}
 
 private:
@@ -1003,6 +1244,15 @@ using api::DIA;
 //! imported from api namespace
 using api::DisjointTag;
 
+//! imported from api namespace
+using api::DuplicateDetectionTag;
+
+//! imported from api namespace
+using api::HashGroupTag;
+
+//! imported from api namespace
+using api::SortedKeyTag;
+
 //! imported from api namespace
 using api::VolatileKeyTag;
 
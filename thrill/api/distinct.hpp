@@ -0,0 +1,285 @@
+/*******************************************************************************
+ * thrill/api/distinct.hpp
+ *
+ * DIANode for a distinct operation, which removes duplicate items.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_API_DISTINCT_HEADER
+#define THRILL_API_DISTINCT_HEADER
+
+#include <thrill/api/dia.hpp>
+#include <thrill/api/dop_node.hpp>
+#include <thrill/common/logger.hpp>
+#include <thrill/core/reduce_functional.hpp>
+#include <thrill/data/file.hpp>
+#include <thrill/mem/malloc_tracker.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace thrill {
+namespace api {
+
+/*!
+ * A DIANode which removes duplicate items from a DIA. In contrast to
+ * ReduceByKey with an identity key extractor, the hash tables store only the
+ * items themselves, not key/value pairs.
+ *
+ * In the PreOp, items are deduplicated locally in a hash set, which is flushed
+ * to the items' hash owners whenever it exceeds its memory share. The receiving
+ * worker inserts all items into a second hash set. If that set exceeds RAM,
+ * its contents and all further items are spilled into hash partition Files,
+ * which are deduplicated one after another. Partitions which again exceed RAM
+ * are recursively split using a hash function with a different salt.
+ *
+ * \ingroup api_layer
+ */
+template <typename ValueType, typename ParentDIA, typename HashFunction>
+class DistinctNode final : public DOpNode<ValueType>
+{
+    static constexpr bool debug = false;
+
+    using Super = DOpNode<ValueType>;
+    using Super::context_;
+
+    using Table = std::unordered_set<ValueType, HashFunction>;
+
+    //! estimated RAM usage per item of an std::unordered_set
+    static constexpr size_t item_overhead_ = 4 * sizeof(void*);
+
+    //! number of hash partitions to spill into if the items exceed RAM.
+    static constexpr size_t num_spill_partitions_ = 32;
+
+    //! maximum recursion depth of spilling, beyond which partitions are
+    //! deduplicated in RAM regardless of their size. This only happens if many
+    //! distinct items have equal hash values.
+    static constexpr size_t max_spill_levels_ = 8;
+
+public:
+    DistinctNode(const ParentDIA& parent, const HashFunction& hash_function)
+        : Super(parent.ctx(), "Distinct", { parent.id() }, { parent.node() }),
+          hash_function_(hash_function),
+          table_(0, hash_function)
+    {
+        // Hook PreOp
+        auto pre_op_fn = [this](const ValueType& input) {
+                             PreOp(input);
+                         };
+        // close the function stack with our pre op and register it at
+        // parent node for output
+        auto lop_chain = parent.stack().push(pre_op_fn).fold();
+        parent.node()->AddChild(this, lop_chain);
+    }
+
+    DIAMemUse PreOpMemUse() final {
+        return DIAMemUse::Max();
+    }
+
+    void StartPreOp(size_t /* id */) final {
+        emitters_ = stream_->GetWriters();
+        limit_items_ = LimitItems();
+    }
+
+    //! Deduplicate locally, send items to hash owners when the table is full.
+    void PreOp(const ValueType& v) {
+        table_.insert(v);
+        if (table_.size() >= limit_items_ || mem::memory_exceeded)
+            FlushTable();
+    }
+
+    void StopPreOp(size_t /* id */) final {
+        FlushTable();
+        // data has been pushed during pre-op -> close emitters
+        for (size_t i = 0; i < emitters_.size(); i++)
+            emitters_[i].Close();
+    }
+
+    DIAMemUse ExecuteMemUse() final {
+        return DIAMemUse::Max();
+    }
+
+    void Execute() final {
+        MainOp();
+    }
+
+    void PushData(bool consume) final {
+        if (spill_files_.empty()) {
+            for (const ValueType& v : table_)
+                this->PushItem(v);
+            if (consume) Table(0, hash_function_).swap(table_);
+        }
+        else {
+            auto reader = output_.GetReader(consume);
+            while (reader.HasNext())
+                this->PushItem(reader.template Next<ValueType>());
+        }
+    }
+
+    void Dispose() final {
+        Table(0, hash_function_).swap(table_);
+        output_.Clear();
+    }
+
+    //! Returns the number of partition Files spilled into, including those of
+    //! recursive splits.
+    size_t num_spill_files() const { return num_spill_files_; }
+
+private:
+    HashFunction hash_function_;
+
+    data::MixStreamPtr stream_ { context_.GetNewMixStream(this) };
+    std::vector<data::Stream::Writer> emitters_;
+
+    //! hash set of items, used in the PreOp and then in the MainOp
+    Table table_;
+
+    //! maximum number of items in table_ before flushing or spilling
+    size_t limit_items_ = 1;
+
+    //! hash partition Files, only used if the received items exceed RAM.
+    std::vector<data::File> spill_files_;
+
+    //! deduplicated items, only used if items were spilled.
+    data::File output_ { context_.GetFile(this) };
+
+    //! statistics: number of spill partition Files created
+    size_t num_spill_files_ = 0;
+
+    //! calculate the item limit of table_ from the node's memory limit
+    size_t LimitItems() const {
+        return std::max<size_t>(
+            1, DIABase::mem_limit_ / (sizeof(ValueType) + item_overhead_));
+    }
+
+    //! hash used to select the worker
+    size_t WorkerHash(const ValueType& v) const {
+        return core::Hash128to64(/* salt */ 0, hash_function_(v));
+    }
+
+    //! hash used to select a spill partition on the given recursion level,
+    //! independent of the worker hash and the other levels.
+    size_t PartitionHash(const ValueType& v, size_t level) const {
+        return core::Hash128to64(/* salt */ 1 + level, hash_function_(v));
+    }
+
+    //! whether table_ exceeds the node's memory
+    bool TableFull() const {
+        return table_.size() >= limit_items_ ||
+               (mem::memory_exceeded && !table_.empty());
+    }
+
+    //! Send all items in the local table to their owners.
+    void FlushTable() {
+        for (const ValueType& v : table_)
+            emitters_[WorkerHash(v) % emitters_.size()].Put(v);
+        table_.clear();
+    }
+
+    //! Write all items in table_ into the spill partition Files of the given
+    //! recursion level, which are created if files is empty.
+    void SpillTable(std::vector<data::File>& files, size_t level) {
+        if (files.empty()) {
+            LOG << "Distinct: items exceed RAM, spilling into partitions"
+                << " on level " << level;
+            for (size_t i = 0; i < num_spill_partitions_; ++i) {
+                files.emplace_back(context_.GetFile(this));
+                files.back().SetEvictionHint(data::EvictionHint::ReadOnce);
+            }
+            num_spill_files_ += num_spill_partitions_;
+        }
+
+        std::vector<data::File::Writer> writers;
+        for (data::File& file : files)
+            writers.emplace_back(file.GetWriter());
+
+        for (const ValueType& v : table_)
+            writers[PartitionHash(v, level) % num_spill_partitions_].Put(v);
+
+        Table(0, hash_function_).swap(table_);
+    }
+
+    //! Deduplicate the items of a spill partition of the given level into
+    //! writer. If they exceed RAM, the partition is split again.
+    void DeduplicateFile(data::File& file, size_t level,
+                         data::File::Writer& writer) {
+        std::vector<data::File> sub_files;
+        {
+            auto reader = file.GetConsumeReader();
+            while (reader.HasNext()) {
+                if (level + 1 < max_spill_levels_ && TableFull())
+                    SpillTable(sub_files, level + 1);
+                table_.insert(reader.template Next<ValueType>());
+            }
+        }
+
+        if (sub_files.empty()) {
+            for (const ValueType& v : table_)
+                writer.Put(v);
+            table_.clear();
+            return;
+        }
+
+        // all copies of an item are in the same sub partition.
+        SpillTable(sub_files, level + 1);
+
+        for (data::File& sub_file : sub_files)
+            DeduplicateFile(sub_file, level + 1, writer);
+    }
+
+    //! Receive elements from other workers and deduplicate them.
+    void MainOp() {
+        limit_items_ = LimitItems();
+
+        auto reader = stream_->GetMixReader(/* consume */ true);
+        while (reader.HasNext()) {
+            if (TableFull())
+                SpillTable(spill_files_, /* level */ 0);
+            table_.insert(reader.template Next<ValueType>());
+        }
+        stream_->Close();
+
+        if (spill_files_.empty()) return;
+
+        // deduplicate each partition separately, all copies of an item are in
+        // the same partition.
+        SpillTable(spill_files_, /* level */ 0);
+
+        data::File::Writer writer = output_.GetWriter();
+        for (data::File& file : spill_files_)
+            DeduplicateFile(file, /* level */ 0, writer);
+        writer.Close();
+
+        LOG << "Distinct: deduplicated " << output_.num_items()
+            << " items from " << num_spill_files_ << " spilled partitions";
+    }
+};
+
+template <typename ValueType, typename Stack>
+template <typename HashFunction>
+auto DIA<ValueType, Stack>::Distinct(
+    const HashFunction &hash_function) const {
+    assert(IsValid());
+
+    using DistinctNode = api::DistinctNode<ValueType, DIA, HashFunction>;
+
+    auto node = common::MakeCounting<DistinctNode>(*this, hash_function);
+
+    return DIA<ValueType>(node);
+}
+
+} // namespace api
+} // namespace thrill
+
+#endif // !THRILL_API_DISTINCT_HEADER
+
+/******************************************************************************/
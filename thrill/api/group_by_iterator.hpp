@@ -34,7 +34,8 @@ namespace api {
 
 // forward declarations for friend classes
 template <typename ValueType, typename ParentDIA,
-          typename KeyExtractor, typename GroupFunction, typename HashFunction>
+          typename KeyExtractor, typename GroupFunction, typename HashFunction,
+          const bool UseHashing>
 class GroupByNode;
 
 template <typename ValueType, typename ParentDIA,
@@ -50,7 +51,8 @@ class GroupByIterator
               typename T2,
               typename T3,
               typename T4,
-              typename T5>
+              typename T5,
+              const bool T6>
     friend class GroupByNode;
 
     template <typename T1,
@@ -134,7 +136,8 @@ class GroupByMultiwayMergeIterator
               typename T2,
               typename T3,
               typename T4,
-              typename T5>
+              typename T5,
+              const bool T6>
     friend class GroupByNode;
 
     template <typename T1,
@@ -210,6 +213,38 @@ private:
     }
 };
 
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+ * Iterator delivering the items of one key group, which are stored
+ * consecutively in a vector by the hash-based GroupByNode.
+ */
+template <typename ValueType>
+class GroupByHashIterator
+{
+public:
+    using ValueIn = ValueType;
+    using Iterator = typename std::vector<ValueIn>::const_iterator;
+
+    GroupByHashIterator(Iterator begin, Iterator end)
+        : iter_(begin), end_(end) { }
+
+    bool HasNext() {
+        return iter_ != end_;
+    }
+
+    ValueIn Next() {
+        assert(iter_ != end_);
+        return *iter_++;
+    }
+
+private:
+    //! current position in the group
+    Iterator iter_;
+    //! end of the group
+    Iterator end_;
+};
+
 //! \}
 
 } // namespace api
@@ -24,6 +24,7 @@
 #include <functional>
 #include <type_traits>
 #include <typeinfo>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -31,10 +32,19 @@ namespace thrill {
 namespace api {
 
 /*!
+ * DIANode for GroupByKey. Items are sent to the worker determined by the hash
+ * of their key. The receiving worker either sorts the items (into external
+ * memory runs if necessary) to find the key groups, or, if UseHashing is set,
+ * collects them in a hash table as long as they fit into RAM.
+ *
+ * \tparam UseHashing Whether to group the received items using a hash table
+ * instead of sorting them. Falls back to sorting if RAM is exceeded.
+ *
  * \ingroup api_layer
  */
 template <typename ValueType, typename ParentDIA,
-          typename KeyExtractor, typename GroupFunction, typename HashFunction>
+          typename KeyExtractor, typename GroupFunction, typename HashFunction,
+          const bool UseHashing = false>
 class GroupByNode final : public DOpNode<ValueType>
 {
     static constexpr bool debug = false;
@@ -101,6 +111,11 @@ public:
             emitter_[i].Close();
     }
 
+    DIAMemUse ExecuteMemUse() final {
+        // the hash grouping keeps items and index in RAM
+        return UseHashing ? DIAMemUse::Max() : DIAMemUse(0);
+    }
+
     void Execute() override {
         MainOp();
     }
@@ -109,7 +124,11 @@ public:
         LOG << "sort data";
         common::StatsTimerStart timer;
         const size_t num_runs = files_.size();
-        if (num_runs == 0) {
+        if (hash_grouped_) {
+            // items were grouped in RAM, call user funcs on each group
+            RunUserFuncHash(consume);
+        }
+        else if (num_runs == 0) {
             // nothing to push
         }
         else if (num_runs == 1) {
@@ -152,7 +171,13 @@ public:
              << " multiwaymerge=" << (num_runs > 1);
     }
 
-    void Dispose() override { }
+    void Dispose() override {
+        std::vector<ValueIn>().swap(hash_items_);
+        std::vector<size_t>().swap(hash_groups_);
+    }
+
+    //! Returns whether the received items were grouped using the hash table.
+    bool hash_grouped() const { return hash_grouped_; }
 
 private:
     KeyExtractor key_extractor_;
@@ -165,6 +190,27 @@ private:
     data::File sorted_elems_ { context_.GetFile(this) };
     size_t totalsize_ = 0;
 
+    //! whether the items were received completely into hash_items_
+    bool hash_grouped_ = false;
+    //! items ordered such that all items of a key group are consecutive
+    std::vector<ValueIn> hash_items_;
+    //! begin of group i in hash_items_, with a sentinel at the end.
+    std::vector<size_t> hash_groups_;
+
+    //! upper bound of the bytes per item of the hash grouping index: the
+    //! target position, a hash map node and bucket, and the group size and
+    //! begin, assuming each item is in its own group.
+    static constexpr size_t hash_index_bytes_ =
+        sizeof(std::pair<const Key, size_t>) + 3 * sizeof(void*)
+        + 3 * sizeof(size_t);
+
+    //! Returns whether incoming and the hash grouping index of its items fit
+    //! into the memory limit.
+    bool HashGroupingFits(const std::vector<ValueIn>& incoming) const {
+        return incoming.capacity() * sizeof(ValueIn)
+               + incoming.size() * hash_index_bytes_ <= DIABase::mem_limit_;
+    }
+
     void RunUserFunc(data::File& f, bool consume) {
         auto r = f.GetReader(consume);
         if (r.HasNext()) {
@@ -184,6 +230,85 @@ private:
         }
     }
 
+    void RunUserFuncHash(bool consume) {
+        for (size_t g = 0; g + 1 < hash_groups_.size(); ++g) {
+            auto user_iterator = GroupByHashIterator<ValueIn>(
+                hash_items_.begin() + hash_groups_[g],
+                hash_items_.begin() + hash_groups_[g + 1]);
+            // call user function
+            const ValueOut res = groupby_function_(
+                user_iterator, key_extractor_(hash_items_[hash_groups_[g]]));
+            // push result to callback functions
+            this->PushItem(res);
+        }
+        if (consume) {
+            std::vector<ValueIn>().swap(hash_items_);
+            std::vector<size_t>().swap(hash_groups_);
+        }
+    }
+
+    //! Group elements using a hash table and store them consecutively by group
+    //! in hash_items_. This is a counting sort by group index, which permutes
+    //! v in place, hence it performs no key comparisons except for the hash
+    //! table lookups, and only needs one index per item as extra space. Returns
+    //! false if RAM is exceeded while grouping, v is then left unchanged.
+    bool GroupVectorByHash(std::vector<ValueIn>& v) {
+        std::unordered_map<Key, size_t, HashFunction> group_index(
+            v.size(), hash_function_);
+        std::vector<size_t> target(v.size());
+
+        // determine group of each item and count the group sizes
+        hash_groups_.clear();
+        for (size_t i = 0; i < v.size(); ++i) {
+            if (mem::memory_exceeded) {
+                LOG << "hash grouping exceeds RAM, falling back to sorting";
+                std::vector<size_t>().swap(hash_groups_);
+                return false;
+            }
+            auto it = group_index.emplace(
+                key_extractor_(v[i]), group_index.size()).first;
+            if (it->second == hash_groups_.size())
+                hash_groups_.push_back(0);
+            target[i] = it->second;
+            ++hash_groups_[it->second];
+        }
+        std::unordered_map<Key, size_t, HashFunction>().swap(group_index);
+
+        // exclusive prefix sum of group sizes -> group begin positions
+        size_t sum = 0;
+        for (size_t& g : hash_groups_) {
+            size_t size = g;
+            g = sum;
+            sum += size;
+        }
+        hash_groups_.push_back(sum);
+
+        // replace the group index of each item by its target position
+        {
+            std::vector<size_t> fill(hash_groups_.begin(), hash_groups_.end());
+            for (size_t i = 0; i < v.size(); ++i)
+                target[i] = fill[target[i]]++;
+        }
+
+        // move items to their target positions by following the cycles of
+        // the permutation
+        for (size_t i = 0; i < v.size(); ++i) {
+            while (target[i] != i) {
+                size_t t = target[i];
+                std::swap(v[i], v[t]);
+                std::swap(target[i], target[t]);
+            }
+        }
+        std::vector<size_t>().swap(target);
+
+        hash_items_ = std::move(v);
+        std::vector<ValueIn>().swap(v);
+
+        totalsize_ += hash_items_.size();
+        hash_grouped_ = true;
+        return true;
+    }
+
     //! Sort and store elements in a file
     void FlushVectorToFile(std::vector<ValueIn>& v) {
         // sort run and sort to file
@@ -206,19 +331,33 @@ private:
 
         std::vector<ValueIn> incoming;
 
+        // group in a hash table until the items no longer fit into RAM
+        bool use_hashing = UseHashing;
+
         common::StatsTimerStart timer;
         // get incoming elements
         auto reader = stream_->GetCatReader(/* consume */ true);
         while (reader.HasNext()) {
             // if vector is full save to disk
             if (mem::memory_exceeded) {
+                if (use_hashing) {
+                    LOG << "hash grouping exceeds RAM, falling back to sorting";
+                    use_hashing = false;
+                }
                 FlushVectorToFile(incoming);
                 incoming.clear();
             }
             // store incoming element
             incoming.emplace_back(reader.template Next<ValueIn>());
+
+            if (use_hashing && !HashGroupingFits(incoming)) {
+                LOG << "hash grouping exceeds mem_limit_,"
+                    << " falling back to sorting";
+                use_hashing = false;
+            }
         }
-        FlushVectorToFile(incoming);
+        if (!use_hashing || !GroupVectorByHash(incoming))
+            FlushVectorToFile(incoming);
         std::vector<ValueIn>().swap(incoming);
         LOG << "finished receiving elems";
         stream_->Close();
@@ -228,7 +367,8 @@ private:
         LOG1 << "RESULT"
              << " name=mainop"
              << " time=" << timer
-             << " number_files=" << files_.size();
+             << " number_files=" << files_.size()
+             << " hash_grouped=" << hash_grouped_;
     }
 };
 
@@ -259,6 +399,33 @@ auto DIA<ValueType, Stack>::GroupByKey(
     return DIA<DOpResult>(node);
 }
 
+template <typename ValueType, typename Stack>
+template <typename ValueOut, typename KeyExtractor,
+          typename GroupFunction, typename HashFunction>
+auto DIA<ValueType, Stack>::GroupByKey(
+    struct HashGroupTag,
+    const KeyExtractor &key_extractor,
+    const GroupFunction &groupby_function) const {
+
+    using DOpResult = ValueOut;
+
+    static_assert(
+        std::is_same<
+            typename std::decay<typename common::FunctionTraits<KeyExtractor>
+                                ::template arg<0> >::type,
+            ValueType>::value,
+        "KeyExtractor has the wrong input type");
+
+    using GroupByNode = api::GroupByNode<
+              DOpResult, DIA, KeyExtractor, GroupFunction, HashFunction,
+              /* UseHashing */ true>;
+
+    auto node = common::MakeCounting<GroupByNode>(
+        *this, key_extractor, groupby_function);
+
+    return DIA<DOpResult>(node);
+}
+
 } // namespace api
 } // namespace thrill
 
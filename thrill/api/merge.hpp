@@ -42,8 +42,9 @@ namespace api {
  * finishes.
  *
  * The algorithm performs a distributed multi-sequence selection by picking
- * random pivots (from the largest remaining interval) for each DIA. The pivots
- * are selected via a global AllReduce. There is one pivot per DIA.
+ * random pivots (from the largest remaining interval) for each splitter. Each
+ * worker samples num_pivots_ sorted pivots from its largest local interval, and
+ * a global AllReduce takes those of the worker with the largest interval.
  *
  * Then the pivots are searched for in the interval [left,left + width) in each
  * local File's partition, where these are initialized with left = 0 and width =
@@ -51,9 +52,11 @@ namespace api {
  * the corresponding global_ranks of each pivot is calculated via a AllReduce.
  *
  * The global_ranks are then compared to the target_ranks (which are n/p *
- * rank). If global_ranks is smaller, the interval [left,left + width) is
- * reduced to [left,idx), where idx is the rank of the pivot in the local
- * File. If global_ranks is larger, the interval is reduced to [idx,left+width).
+ * rank). The interval [left,left + width) is reduced to [idx_lo,idx_hi), where
+ * idx_lo is the local rank of the greatest pivot with a smaller global rank and
+ * idx_hi that of the next pivot. Each round hence shrinks the intervals by
+ * about a factor of num_pivots_, and the search needs O(log_s n) rounds of two
+ * collectives each, where s = num_pivots_.
  *
  * left  -> width
  * V            V      V           V         V                   V
@@ -191,6 +194,10 @@ private:
     //! Merge comparator
     Comparator comparator_;
 
+    //! Number of pivots searched for each splitter in each round, which
+    //! shrinks the search ranges by about this factor per round.
+    static constexpr size_t num_pivots_ = 8;
+
     //! Random generator for pivot selection.
     std::default_random_engine rng_ { std::random_device { } () };
 
@@ -347,7 +354,17 @@ private:
 
     /*!
      * Selects random global pivots for all splitter searches based on all
-     * worker's search ranges.
+     * worker's search ranges. For each splitter, num_pivots_ pivots are sampled
+     * locally from the largest local range, one from each of num_pivots_ equal
+     * parts of the range, hence the pivots are sorted. The global reduction
+     * then takes the samples of the worker with the largest range.
+     *
+     * The reduction must stay: pivots are items, and the items of a search
+     * range are only stored on the worker owning it, so a shared random seed
+     * cannot replace sending them. The reduction transfers one worker's
+     * num_pivots_ items per splitter through the reduction tree, while an
+     * all-gather of every worker's local samples would transfer num_workers
+     * times as many items.
      *
      * \param left The left bounds of all search ranges for all files.  The
      * first index identifies the splitter, the second index identifies the
@@ -356,14 +373,14 @@ private:
      * \param width The width of all search ranges for all files.  The first
      * index identifies the splitter, the second index identifies the file.
      *
-     * \param out_pivots The output pivots.
+     * \param out_pivots The output pivots, num_pivots_ for each splitter.
      */
     void SelectPivots(
         const std::vector<ArrayNumInputsSizeT>& left,
         const std::vector<ArrayNumInputsSizeT>& width,
         std::vector<Pivot>& out_pivots) {
 
-        // Select a random pivot for the largest range we have for each
+        // Select random pivots for the largest range we have for each
         // splitter.
         for (size_t s = 0; s < width.size(); s++) {
             size_t mp = 0;
@@ -375,31 +392,40 @@ private:
                 }
             }
 
-            // We can leave pivot_elem uninitialized.  If it is not initialized
-            // below, then an other worker's pivot will be taken for this range,
-            // since our range is zero.
-            ValueType pivot_elem = ValueType();
-            size_t pivot_idx = left[s][mp];
-
-            if (width[s][mp] > 0) {
-                pivot_idx = left[s][mp] + (rng_() % width[s][mp]);
-                assert(pivot_idx < files_[mp]->num_items());
-                stats_.file_op_timer_.Start();
-                pivot_elem = files_[mp]->template GetItemAt<ValueType>(pivot_idx);
-                stats_.file_op_timer_.Stop();
-            }
+            for (size_t k = 0; k < num_pivots_; ++k) {
+                // We can leave pivot_elem uninitialized.  If it is not
+                // initialized below, then an other worker's pivot will be
+                // taken for this range, since our range is zero.
+                ValueType pivot_elem = ValueType();
+                size_t pivot_idx = left[s][mp];
+
+                if (width[s][mp] > 0) {
+                    // sample from the k-th part of the range
+                    size_t part_begin = width[s][mp] * k / num_pivots_;
+                    size_t part_end = width[s][mp] * (k + 1) / num_pivots_;
+                    pivot_idx = left[s][mp] + part_begin;
+                    if (part_end > part_begin)
+                        pivot_idx += rng_() % (part_end - part_begin);
+                    assert(pivot_idx < files_[mp]->num_items());
+                    stats_.file_op_timer_.Start();
+                    pivot_elem =
+                        files_[mp]->template GetItemAt<ValueType>(pivot_idx);
+                    stats_.file_op_timer_.Stop();
+                }
 
-            out_pivots[s] = Pivot {
-                pivot_elem,
-                pivot_idx,
-                width[s][mp]
-            };
+                out_pivots[s * num_pivots_ + k] = Pivot {
+                    pivot_elem,
+                    pivot_idx,
+                    width[s][mp]
+                };
+            }
         }
 
         LOG << "local pivots: " << VToStr(out_pivots);
 
         // Reduce vectors of pivots globally to select the pivots from the
-        // largest ranges.
+        // largest ranges. All pivots of a splitter have the same segment_len,
+        // hence they are all taken from the same worker.
         stats_.comm_timer_.Start();
         out_pivots = context_.net.AllReduce(
             out_pivots, AddSizeTVectors<Pivot, ReducePivots>());
@@ -418,23 +444,27 @@ private:
         const std::vector<ArrayNumInputsSizeT>& width) {
 
         // Simply get the rank of each pivot in each file. Sum the ranks up
-        // locally.
-        for (size_t s = 0; s < pivots.size(); s++) {
-            size_t rank = 0;
+        // locally. The pivots of a splitter are sorted, hence the search for
+        // each pivot starts at the rank of the previous one.
+        std::fill(global_ranks.begin(), global_ranks.end(), 0);
+        for (size_t s = 0; s < width.size(); s++) {
             for (size_t i = 0; i < kNumInputs; i++) {
-                stats_.file_op_timer_.Start();
+                size_t begin = left[s][i], end = left[s][i] + width[s][i];
 
-                size_t idx = files_[i]->GetIndexOf(
-                    pivots[s].value, pivots[s].tie_idx,
-                    left[s][i], left[s][i] + width[s][i],
-                    comparator_);
+                for (size_t k = 0; k < num_pivots_; ++k) {
+                    const Pivot& pivot = pivots[s * num_pivots_ + k];
+                    stats_.file_op_timer_.Start();
 
-                stats_.file_op_timer_.Stop();
+                    size_t idx = files_[i]->GetIndexOf(
+                        pivot.value, pivot.tie_idx, begin, end, comparator_);
 
-                rank += idx;
-                out_local_ranks[s][i] = idx;
+                    stats_.file_op_timer_.Stop();
+
+                    global_ranks[s * num_pivots_ + k] += idx;
+                    out_local_ranks[s * num_pivots_ + k][i] = idx;
+                    begin = idx;
+                }
             }
-            global_ranks[s] = rank;
         }
 
         stats_.comm_timer_.Start();
@@ -445,7 +475,10 @@ private:
     }
 
     /*!
-     * Shrinks the search ranges according to the global ranks of the pivots.
+     * Shrinks the search ranges according to the global ranks of the pivots:
+     * the new range of each splitter lies between the greatest pivot with
+     * global rank less than the target rank and the next pivot. Additionally,
+     * remembers the pivot whose global rank is closest to the target rank.
      *
      * \param global_ranks The global ranks of all pivots.
      *
@@ -461,31 +494,57 @@ private:
      * \param width The width of all search ranges for all files.  The first
      * index identifies the splitter, the second index identifies the file.
      * This parameter will be modified.
+     *
+     * \param best_global_ranks The global rank of the best pivot found so far
+     * for each splitter. This parameter will be modified.
+     *
+     * \param best_local_ranks The local ranks of the best pivot found so far
+     * for each splitter. This parameter will be modified.
      */
     void SearchStep(
         const std::vector<size_t>& global_ranks,
         const std::vector<ArrayNumInputsSizeT>& local_ranks,
         const std::vector<size_t>& target_ranks,
         std::vector<ArrayNumInputsSizeT>& left,
-        std::vector<ArrayNumInputsSizeT>& width) {
+        std::vector<ArrayNumInputsSizeT>& width,
+        std::vector<size_t>& best_global_ranks,
+        std::vector<ArrayNumInputsSizeT>& best_local_ranks) {
 
         for (size_t s = 0; s < width.size(); s++) {
+            const size_t* ranks = global_ranks.data() + s * num_pivots_;
+
+            // find the pivots enclosing the target rank, the global ranks of
+            // the pivots are ascending.
+            size_t lo = num_pivots_, hi = num_pivots_;
+            for (size_t k = 0; k < num_pivots_; ++k) {
+                if (ranks[k] < target_ranks[s])
+                    lo = k;
+                else if (hi == num_pivots_)
+                    hi = k;
+
+                if (common::abs_diff(ranks[k], target_ranks[s]) <
+                    common::abs_diff(best_global_ranks[s], target_ranks[s])) {
+                    best_global_ranks[s] = ranks[k];
+                    best_local_ranks[s] = local_ranks[s * num_pivots_ + k];
+                }
+            }
+
             for (size_t p = 0; p < width[s].size(); p++) {
 
                 if (width[s][p] == 0)
                     continue;
 
-                size_t local_rank = local_ranks[s][p];
+                size_t begin = left[s][p], end = left[s][p] + width[s][p];
                 size_t old_width = width[s][p];
-                assert(left[s][p] <= local_rank);
 
-                if (global_ranks[s] < target_ranks[s]) {
-                    width[s][p] -= local_rank - left[s][p];
-                    left[s][p] = local_rank;
-                }
-                else if (global_ranks[s] >= target_ranks[s]) {
-                    width[s][p] = local_rank - left[s][p];
-                }
+                if (lo != num_pivots_)
+                    begin = local_ranks[s * num_pivots_ + lo][p];
+                if (hi != num_pivots_)
+                    end = local_ranks[s * num_pivots_ + hi][p];
+
+                assert(left[s][p] <= begin && begin <= end);
+                left[s][p] = begin;
+                width[s][p] = end - begin;
 
                 if (debug) {
                     die_unless(width[s][p] <= old_width);
@@ -557,15 +616,20 @@ private:
             stats_.comm_timer_.Stop();
         }
 
-        // buffer for the global ranks of selected pivots
+        // global and local ranks of the best pivot found for each splitter,
+        // initially the empty prefix.
         std::vector<size_t> global_ranks(p - 1);
+        std::vector<ArrayNumInputsSizeT> local_ranks(p - 1);
 
         // Search range bounds.
         std::vector<ArrayNumInputsSizeT> left(p - 1), width(p - 1);
 
-        // Auxillary arrays.
-        std::vector<Pivot> pivots(p - 1);
-        std::vector<ArrayNumInputsSizeT> local_ranks(p - 1);
+        // Auxillary arrays: pivots of each round, num_pivots_ per splitter, and
+        // their ranks.
+        std::vector<Pivot> pivots((p - 1) * num_pivots_);
+        std::vector<size_t> pivot_global_ranks((p - 1) * num_pivots_);
+        std::vector<ArrayNumInputsSizeT> pivot_local_ranks(
+            (p - 1) * num_pivots_);
 
         // Initialize all lefts with 0 and all widths with size of their
         // respective file.
@@ -606,12 +670,17 @@ private:
 
             // Get global ranks and shrink ranges.
             stats_.search_step_timer_.Start();
-            GetGlobalRanks(pivots, global_ranks, local_ranks, left, width);
+            GetGlobalRanks(pivots, pivot_global_ranks, pivot_local_ranks,
+                           left, width);
 
-            LOG << "global_ranks: " << common::VecToStr(global_ranks);
-            LOG << "local_ranks: " << VecVecToStr(local_ranks);
+            LOG << "pivot global_ranks: "
+                << common::VecToStr(pivot_global_ranks);
+            LOG << "pivot local_ranks: " << VecVecToStr(pivot_local_ranks);
 
-            SearchStep(global_ranks, local_ranks, target_ranks, left, width);
+            SearchStep(pivot_global_ranks, pivot_local_ranks, target_ranks,
+                       left, width, global_ranks, local_ranks);
+
+            LOG << "global_ranks: " << common::VecToStr(global_ranks);
 
             if (debug) {
                 for (size_t q = 0; q < kNumInputs; q++) {
@@ -20,9 +20,14 @@
 #include <thrill/common/logger.hpp>
 #include <thrill/common/string.hpp>
 #include <thrill/common/system_exception.hpp>
+#include <thrill/core/bgzf.hpp>
 #include <thrill/core/file_io.hpp>
+#include <thrill/io/syscall_file.hpp>
 #include <thrill/net/buffer_builder.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
@@ -67,12 +72,20 @@ public:
         : ReadLinesNode(ctx, std::vector<std::string>{ glob }) { }
 
     DIAMemUse PushDataMemUse() final {
-        // InputLineIterators read files block-wise
-        return data::default_block_size;
+        // InputLineIterators read files block-wise, with one block readahead
+        return 2 * data::default_block_size;
     }
 
     void PushData(bool /* consume */) final {
-        if (filelist_.contains_compressed) {
+        if (filelist_.contains_compressed && IsSplittable()) {
+            InputLineIteratorBgzf it(filelist_, *this);
+
+            // Hook Read
+            while (it.HasNext()) {
+                this->PushItem(it.Next());
+            }
+        }
+        else if (filelist_.contains_compressed) {
             InputLineIteratorCompressed it = InputLineIteratorCompressed(
                 filelist_, *this);
 
@@ -82,8 +95,7 @@ public:
             }
         }
         else {
-            InputLineIteratorUncompressed it = InputLineIteratorUncompressed(
-                filelist_, *this);
+            InputLineIteratorUncompressed it(filelist_, *this);
 
             // Hook Read
             while (it.HasNext()) {
@@ -95,6 +107,17 @@ public:
 private:
     core::SysFileList filelist_;
 
+    //! Returns true if all compressed files are in BGZF format, hence all
+    //! files can be split among workers and decompressed in-process.
+    bool IsSplittable() const {
+        for (size_t i = 0; i < filelist_.count(); ++i) {
+            const core::SysFileInfo& fi = filelist_.list[i];
+            if (fi.IsCompressed() && !core::BgzfReader::IsBgzfFile(fi.path))
+                return false;
+        }
+        return true;
+    }
+
     class InputLineIterator
     {
     public:
@@ -162,7 +185,9 @@ private:
         }
     };
 
-    //! InputLineIterator gives you access to lines of a file
+    //! InputLineIterator gives you access to lines of a file. The file is
+    //! read with asynchronous requests of the io layer into two alternating
+    //! buffers, such that the next block is read while lines are scanned.
     class InputLineIteratorUncompressed : public InputLineIterator
     {
     public:
@@ -177,21 +202,18 @@ private:
             while (files_.list[current_file_].size_inc_psum() <= my_range_.begin) {
                 current_file_++;
             }
-            if (my_range_.begin < my_range_.end) {
-                LOG << "Opening file " << current_file_;
-                file_ = core::SysFile::OpenForRead(files_.list[current_file_].path);
-            }
-            else {
+            if (my_range_.begin >= my_range_.end) {
                 LOG << "my_range : " << my_range_;
                 return;
             }
 
             // find offset in current file:
             // offset = start - sum of previous file sizes
-            offset_ = file_.lseek(
-                static_cast<off_t>(my_range_.begin - files_.list[current_file_].size_ex_psum));
+            offset_ = my_range_.begin - files_.list[current_file_].size_ex_psum;
             buffer_.Reserve(read_size);
-            ReadBlock(file_, buffer_);
+            next_buffer_.Reserve(read_size);
+            OpenFile(offset_);
+            ReadAheadBlock();
 
             if (offset_ != 0) {
                 bool found_n = false;
@@ -199,25 +221,33 @@ private:
                 // find next newline, discard all previous data as previous
                 // worker already covers it
                 while (!found_n) {
-                    while (current_ < buffer_.end()) {
-                        if (THRILL_UNLIKELY(*current_++ == '\n')) {
-                            found_n = true;
-                            break;
-                        }
+                    unsigned char* nl = FindNewline();
+                    if (nl != nullptr) {
+                        current_ = nl + 1;
+                        found_n = true;
+                        break;
                     }
+                    current_ = buffer_.end();
                     // no newline found: read new data into buffer_builder
-                    if (!found_n) {
-                        offset_ += buffer_.size();
-                        if (!ReadBlock(file_, buffer_)) {
-                            // EOF = newline per definition
-                            found_n = true;
-                        }
+                    offset_ += buffer_.size();
+                    if (!ReadAheadBlock()) {
+                        // EOF = newline per definition
+                        found_n = true;
                     }
                 }
             }
             data_.reserve(4 * 1024);
         }
 
+        ~InputLineIteratorUncompressed() {
+            // cancel or wait for the outstanding readahead request, it
+            // writes into next_buffer_.
+            if (next_request_) {
+                next_request_->cancel();
+                next_request_->wait();
+            }
+        }
+
         //! returns the next element if one exists
         //!
         //! does no checks whether a next element exists!
@@ -225,27 +255,27 @@ private:
             total_elements_++;
             data_.clear();
             while (true) {
-                while (current_ < buffer_.end()) {
-                    if (THRILL_UNLIKELY(*current_ == '\n')) {
-                        current_++;
-                        return data_;
-                    }
-                    else {
-                        data_.push_back(*current_++);
-                    }
+                unsigned char* nl = FindNewline();
+                if (nl != nullptr) {
+                    data_.append(reinterpret_cast<const char*>(current_),
+                                 nl - current_);
+                    current_ = nl + 1;
+                    return data_;
                 }
+                data_.append(reinterpret_cast<const char*>(current_),
+                             buffer_.end() - current_);
+                current_ = buffer_.end();
+
                 offset_ += buffer_.size();
-                if (!ReadBlock(file_, buffer_)) {
+                if (!ReadAheadBlock()) {
                     LOG << "opening next file";
 
-                    file_.close();
                     current_file_++;
                     offset_ = 0;
 
                     if (current_file_ < files_.count()) {
-                        file_ = core::SysFile::OpenForRead(files_.list[current_file_].path);
-                        offset_ += buffer_.size();
-                        ReadBlock(file_, buffer_);
+                        OpenFile(0);
+                        ReadAheadBlock();
                     }
                     else {
                         current_ = buffer_.begin() +
@@ -273,7 +303,66 @@ private:
         //! Offset of current block in file_.
         size_t offset_ = 0;
         //! File handle to files_[current_file_]
-        core::SysFile file_;
+        io::FileBasePtr file_;
+        //! Buffer of the next block, which is being read asynchronously.
+        net::BufferBuilder next_buffer_;
+        //! Outstanding read request for next_buffer_, or nullptr.
+        io::RequestPtr next_request_;
+        //! Offset of the next block in file_.
+        size_t next_offset_ = 0;
+        //! Size of the next block in file_, zero at the end of file_.
+        size_t next_size_ = 0;
+
+        //! Find the next newline in [current_, buffer_.end()), or nullptr.
+        unsigned char * FindNewline() const {
+            return static_cast<unsigned char*>(
+                std::memchr(current_, '\n', buffer_.end() - current_));
+        }
+
+        //! Open files_[current_file_] and issue a read of the first block
+        //! at the given offset.
+        void OpenFile(size_t offset) {
+            LOG << "Opening file " << current_file_;
+            file_ = io::FileBasePtr(
+                new io::SyscallFile(
+                    files_.list[current_file_].path,
+                    io::FileBase::RDONLY | io::FileBase::NO_LOCK));
+            next_offset_ = offset;
+            IssueRead();
+        }
+
+        //! Issue an asynchronous read of the block at next_offset_.
+        void IssueRead() {
+            next_size_ = std::min(
+                read_size, files_.list[current_file_].size - next_offset_);
+            if (next_size_ == 0) return;
+            next_request_ = file_->aread(
+                next_buffer_.data(), next_offset_, next_size_);
+        }
+
+        //! Wait for the outstanding read, swap it into buffer_, and issue
+        //! the read of the following block. Returns false at end of file.
+        bool ReadAheadBlock() {
+            read_timer.Start();
+            if (next_request_) {
+                next_request_->wait();
+                next_request_ = io::RequestPtr();
+            }
+            read_timer.Stop();
+
+            std::swap(buffer_, next_buffer_);
+            buffer_.set_size(next_size_);
+            current_ = buffer_.begin();
+            total_bytes_ += next_size_;
+            total_reads_++;
+            LOG << "Opening block with " << next_size_ << " bytes.";
+
+            if (next_size_ == 0) return false;
+
+            next_offset_ += next_size_;
+            IssueRead();
+            return true;
+        }
     };
 
     //! InputLineIterator gives you access to lines of a file
@@ -327,15 +416,17 @@ private:
             total_elements_++;
             data_.clear();
             while (true) {
-                while (current_ < buffer_.end()) {
-                    if (THRILL_UNLIKELY(*current_ == '\n')) {
-                        current_++;
-                        return data_;
-                    }
-                    else {
-                        data_.push_back(*current_++);
-                    }
+                unsigned char* nl = static_cast<unsigned char*>(
+                    std::memchr(current_, '\n', buffer_.end() - current_));
+                if (nl != nullptr) {
+                    data_.append(reinterpret_cast<const char*>(current_),
+                                 nl - current_);
+                    current_ = nl + 1;
+                    return data_;
                 }
+                data_.append(reinterpret_cast<const char*>(current_),
+                             buffer_.end() - current_);
+                current_ = buffer_.end();
 
                 if (!ReadBlock(file_, buffer_)) {
                     LOG << "Opening new file!";
@@ -402,6 +493,204 @@ private:
         //! File handle to files_[current_file_]
         core::SysFile file_;
     };
+
+    /*!
+     * InputLineIterator for lists of uncompressed and BGZF compressed files,
+     * which are split by their compressed sizes among the workers like
+     * uncompressed files. Each worker decompresses the BGZF blocks starting in
+     * its local range in-process.
+     *
+     * A line is read by the worker whose range contains the line's start: in
+     * uncompressed files the byte offset, and in BGZF files the offset of the
+     * first block which does not start before the line. Hence, the first
+     * partial line is skipped, and lines are read until the first line
+     * beginning after the first block which is not in the local range.
+     */
+    class InputLineIteratorBgzf : public InputLineIterator
+    {
+    public:
+        //! Creates an instance of iterator that reads file line based
+        InputLineIteratorBgzf(const core::SysFileList& files,
+                              ReadLinesNode& node)
+            : InputLineIterator(files, node) {
+
+            // Go to start of 'local part'.
+            my_range_ = node_.context_.CalculateLocalRange(files.total_size);
+
+            while (current_file_ < files_.count() &&
+                   files_.list[current_file_].size_inc_psum()
+                   <= my_range_.begin) {
+                current_file_++;
+            }
+
+            buffer_.Reserve(
+                std::max(read_size, core::BgzfReader::max_block_size));
+            current_ = buffer_.begin();
+            data_.reserve(4 * 1024);
+        }
+
+        //! returns true, if an element is available in local part
+        bool HasNext() {
+            if (has_line_) return true;
+
+            while (current_file_ < files_.count() &&
+                   files_.list[current_file_].size_ex_psum < my_range_.end)
+            {
+                if (!file_open_) OpenFile();
+
+                if (ReadLine()) {
+                    has_line_ = true;
+                    return true;
+                }
+
+                LOG << "opening next file";
+                file_.close();
+                bgzf_reader_.Close();
+                file_open_ = false;
+                current_file_++;
+            }
+            return false;
+        }
+
+        //! returns the next element, HasNext() must have returned true.
+        const std::string& Next() {
+            assert(has_line_);
+            has_line_ = false;
+            total_elements_++;
+            return data_;
+        }
+
+    private:
+        //! whether files_[current_file_] is opened
+        bool file_open_ = false;
+        //! whether the current file is BGZF compressed
+        bool is_bgzf_ = false;
+        //! whether the end of the current file was reached
+        bool eof_ = false;
+        //! whether data_ contains a line which was not yet returned
+        bool has_line_ = false;
+        //! File handle to an uncompressed files_[current_file_]
+        core::SysFile file_;
+        //! Reader for a BGZF compressed files_[current_file_]
+        core::BgzfReader bgzf_reader_;
+        //! (exclusive) end of the local range in the current file
+        uint64_t file_end_ = 0;
+        //! decoded offset of buffer_.begin() in the current file
+        uint64_t pos_ = 0;
+        //! decoded offset of the end of the local range in the current file,
+        //! for BGZF files only known after reaching it.
+        uint64_t pos_end_ = 0;
+
+        //! Open files_[current_file_] at the start of the local range and
+        //! skip the partial line owned by the previous worker.
+        void OpenFile() {
+            const core::SysFileInfo& fi = files_.list[current_file_];
+            uint64_t file_begin = my_range_.begin > fi.size_ex_psum
+                                  ? my_range_.begin - fi.size_ex_psum : 0;
+            file_end_ = std::min<uint64_t>(
+                my_range_.end - fi.size_ex_psum, fi.size);
+
+            LOG << "Opening file " << current_file_
+                << " range " << file_begin << " - " << file_end_;
+
+            file_open_ = true;
+            is_bgzf_ = fi.IsCompressed();
+            eof_ = false;
+            buffer_.set_size(0);
+            current_ = buffer_.begin();
+
+            bool skip;
+            if (is_bgzf_) {
+                bgzf_reader_.Open(fi.path, file_begin);
+                pos_ = 0;
+                pos_end_ = std::numeric_limits<uint64_t>::max();
+                skip = bgzf_reader_.next_offset() > 0;
+                // no block starts in the local range
+                if (bgzf_reader_.next_offset() >= file_end_) eof_ = true;
+            }
+            else {
+                file_ = core::SysFile::OpenForRead(fi.path);
+                if (file_begin != 0) {
+                    size_t p = file_.lseek(static_cast<off_t>(file_begin));
+                    die_unequal(file_begin, p);
+                }
+                pos_ = file_begin;
+                pos_end_ = file_end_;
+                skip = file_begin > 0;
+            }
+
+            if (skip) ScanLine(/* store */ false);
+        }
+
+        //! Read the next chunk of the current file into buffer_, skipping
+        //! empty BGZF blocks. Returns false at end of file.
+        bool LoadChunk() {
+            pos_ += buffer_.size();
+            buffer_.set_size(0);
+            current_ = buffer_.begin();
+            if (eof_) return false;
+
+            read_timer.Start();
+            ssize_t bytes;
+            if (is_bgzf_) {
+                do {
+                    if (pos_end_ == std::numeric_limits<uint64_t>::max() &&
+                        bgzf_reader_.next_offset() >= file_end_)
+                        pos_end_ = pos_;
+                    bytes = bgzf_reader_.ReadBlock(buffer_.data());
+                } while (bytes == 0);
+            }
+            else {
+                bytes = file_.read(buffer_.data(), read_size);
+                if (bytes < 0) {
+                    throw common::ErrnoException("Read error");
+                }
+            }
+            read_timer.Stop();
+
+            if (bytes <= 0) {
+                eof_ = true;
+                return false;
+            }
+            buffer_.set_size(bytes);
+            total_bytes_ += bytes;
+            total_reads_++;
+            return true;
+        }
+
+        //! Scan to after the next newline or the end of file, and store the
+        //! line in data_ if requested.
+        void ScanLine(bool store) {
+            data_.clear();
+            while (true) {
+                unsigned char* nl = static_cast<unsigned char*>(
+                    std::memchr(current_, '\n', buffer_.end() - current_));
+                if (nl != nullptr) {
+                    if (store) {
+                        data_.append(reinterpret_cast<const char*>(current_),
+                                     nl - current_);
+                    }
+                    current_ = nl + 1;
+                    return;
+                }
+                if (store) {
+                    data_.append(reinterpret_cast<const char*>(current_),
+                                 buffer_.end() - current_);
+                }
+                current_ = buffer_.end();
+                if (!LoadChunk()) return;
+            }
+        }
+
+        //! Read the next line of the local range into data_, returns false if
+        //! the current file has no more local lines.
+        bool ReadLine() {
+            if (current_ == buffer_.end() && !LoadChunk()) return false;
+            if (pos_ + (current_ - buffer_.begin()) > pos_end_) return false;
+            ScanLine(/* store */ true);
+            return true;
+        }
+    };
 };
 
 /*!
@@ -0,0 +1,174 @@
+/*******************************************************************************
+ * thrill/api/rebalance.hpp
+ *
+ * DIANode for a rebalance operation, which redistributes the items of a DIA
+ * evenly across all workers while keeping their order.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_API_REBALANCE_HEADER
+#define THRILL_API_REBALANCE_HEADER
+
+#include <thrill/api/dia.hpp>
+#include <thrill/api/dop_node.hpp>
+#include <thrill/common/logger.hpp>
+#include <thrill/common/string.hpp>
+#include <thrill/data/file.hpp>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace thrill {
+namespace api {
+
+/*!
+ * A DIANode which redistributes the items of a DIA such that worker i holds
+ * the global range [i * total / p, (i+1) * total / p) of the items. The order
+ * of the items is not changed.
+ *
+ * The node first calculates the global rank of its local items using an
+ * exclusive prefix sum and the total and maximum local size using an
+ * AllReduce. If the largest worker holds at most (1 + max_imbalance) times the
+ * average number of items, then no items are transferred. Otherwise, the local
+ * File is scattered to the target workers via a CatStream, using the same
+ * offset calculation as Concat.
+ *
+ * \ingroup api_layer
+ */
+template <typename ValueType, typename ParentDIA>
+class RebalanceNode final : public DOpNode<ValueType>
+{
+    static constexpr bool debug = false;
+
+    using Super = DOpNode<ValueType>;
+    using Super::context_;
+
+    //! pair of (sum, max) of the local sizes
+    using SizeSumMax = std::array<size_t, 2>;
+
+public:
+    RebalanceNode(const ParentDIA& parent, double max_imbalance)
+        : Super(parent.ctx(), "Rebalance", { parent.id() }, { parent.node() }),
+          max_imbalance_(max_imbalance)
+    {
+        auto save_fn = [this](const ValueType& input) {
+                           writer_.Put(input);
+                       };
+        auto lop_chain = parent.stack().push(save_fn).fold();
+        parent.node()->AddChild(this, lop_chain);
+    }
+
+    //! Receive a whole data::File of ValueType, but only if our stack is empty.
+    bool OnPreOpFile(const data::File& file, size_t /* parent_index */) final {
+        if (!ParentDIA::stack_empty) return false;
+        assert(file_.num_items() == 0);
+        file_ = file.Copy();
+        return true;
+    }
+
+    void StopPreOp(size_t /* id */) final {
+        writer_.Close();
+    }
+
+    void Execute() final {
+        MainOp();
+    }
+
+    void PushData(bool consume) final {
+        this->PushFile(file_, consume);
+    }
+
+    void Dispose() final {
+        file_.Clear();
+    }
+
+private:
+    //! maximum relative imbalance of the largest worker which is tolerated
+    double max_imbalance_;
+
+    //! Local data file, contains the rebalanced items after Execute().
+    data::File file_ { context_.GetFile(this) };
+    //! Data writer to local file (only active in PreOp).
+    data::File::Writer writer_ { file_.GetWriter() };
+
+    void MainOp() {
+        const size_t num_workers = context_.num_workers();
+        const size_t local_size = file_.num_items();
+
+        //! global rank of the first local item
+        size_t local_rank = context_.net.ExPrefixSum(local_size);
+
+        SizeSumMax sum_max = context_.net.AllReduce(
+            SizeSumMax { { local_size, local_size } },
+            [](const SizeSumMax& a, const SizeSumMax& b) {
+                return SizeSumMax {
+                    { a[0] + b[0], std::max(a[1], b[1]) }
+                };
+            });
+
+        const size_t total_items = sum_max[0];
+        const double per_pe =
+            static_cast<double>(total_items) / static_cast<double>(num_workers);
+
+        sLOG << "Rebalance: local_size" << local_size
+             << "local_rank" << local_rank
+             << "total_items" << total_items << "max_size" << sum_max[1];
+
+        // skip the data exchange if the largest worker is close to average
+        if (static_cast<double>(sum_max[1]) <= (1.0 + max_imbalance_) * per_pe) {
+            LOG << "Rebalance: imbalance below threshold, no items transferred";
+            return;
+        }
+
+        // calculate offset vector as in Concat: worker p receives items from
+        // global rank p * per_pe onward.
+        std::vector<size_t> offsets(num_workers + 1, 0);
+        for (size_t p = 0; p < num_workers; ++p) {
+            size_t limit =
+                static_cast<size_t>(static_cast<double>(p) * per_pe);
+            if (limit < local_rank) continue;
+
+            offsets[p] = std::min(limit - local_rank, local_size);
+        }
+        offsets[num_workers] = local_size;
+
+        LOG << "Rebalance: offsets = " << common::VecToStr(offsets);
+
+        data::CatStreamPtr stream = context_.GetNewCatStream(this);
+        stream->template Scatter<ValueType>(file_, offsets, /* consume */ true);
+
+        // receive items in worker order into the (now empty) local File
+        file_.Clear();
+        data::File::Writer writer = file_.GetWriter();
+        auto reader = stream->GetCatReader(/* consume */ true);
+        while (reader.HasNext())
+            writer.Put(reader.template Next<ValueType>());
+        writer.Close();
+        stream->Close();
+    }
+};
+
+template <typename ValueType, typename Stack>
+DIA<ValueType> DIA<ValueType, Stack>::Rebalance(double max_imbalance) const {
+    assert(IsValid());
+
+    using RebalanceNode = api::RebalanceNode<ValueType, DIA>;
+
+    auto node = common::MakeCounting<RebalanceNode>(*this, max_imbalance);
+
+    return DIA<ValueType>(node);
+}
+
+} // namespace api
+} // namespace thrill
+
+#endif // !THRILL_API_REBALANCE_HEADER
+
+/******************************************************************************/
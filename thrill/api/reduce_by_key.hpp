@@ -20,12 +20,18 @@
 #include <thrill/api/dop_node.hpp>
 #include <thrill/common/functional.hpp>
 #include <thrill/common/logger.hpp>
+#include <thrill/common/math.hpp>
 #include <thrill/common/meta.hpp>
 #include <thrill/common/porting.hpp>
+#include <thrill/core/duplicate_detection.hpp>
+#include <thrill/core/multiway_merge.hpp>
 #include <thrill/core/reduce_by_hash_post_stage.hpp>
 #include <thrill/core/reduce_pre_stage.hpp>
+#include <thrill/data/file.hpp>
 
+#include <algorithm>
 #include <functional>
+#include <random>
 #include <thread>
 #include <type_traits>
 #include <typeinfo>
@@ -223,6 +229,573 @@ private:
     bool reduced_ = false;
 };
 
+/*!
+ * A DIANode which performs a ReduceByKey operation and delivers the reduced
+ * items sorted by key. Instead of hashing, the keys are range-partitioned
+ * using sampled splitters, hence the output is globally sorted after a single
+ * shuffle, and each worker sorts only its final reduced items.
+ *
+ * In the PreOp, items are reduced locally in a single-partition pre stage,
+ * which writes the partially reduced items into a local File. The MainOp
+ * samples keys from this File, selects p-1 splitters from all samples via an
+ * AllReduce, and sends each partially reduced item to the worker owning its key
+ * range. The post stage reduces the received items, which are sorted by key in
+ * runs bounded by the memory limit and merged if necessary.
+ *
+ * \tparam ValueType Output type of the Reduce operation
+ * \tparam ParentDIA Type of the parent DIA.
+ * \tparam KeyExtractor Type of the key_extractor function.
+ * \tparam ReduceFunction Type of the reduce_function.
+ *
+ * \ingroup api_layer
+ */
+template <typename ValueType, typename ParentDIA,
+          typename KeyExtractor, typename ReduceFunction,
+          typename ReduceConfig>
+class SortedReduceNode final : public DOpNode<ValueType>
+{
+    static constexpr bool debug = false;
+
+    using Super = DOpNode<ValueType>;
+    using Super::context_;
+
+    using Key = typename common::FunctionTraits<KeyExtractor>::result_type;
+
+    static constexpr bool use_mix_stream_ = ReduceConfig::use_mix_stream_;
+
+    //! average number of key samples drawn per worker and log2(workers)
+    static constexpr size_t oversampling_factor_ = 64;
+
+private:
+    //! Emitter for PostStage to collect the reduced items for sorting.
+    class Emitter
+    {
+    public:
+        explicit Emitter(SortedReduceNode* node) : node_(node) { }
+        void operator () (const ValueType& item) const
+        { return node_->AddReducedItem(item); }
+
+    private:
+        SortedReduceNode* node_;
+    };
+
+public:
+    /*!
+     * Constructor for a SortedReduceNode. Sets the parent, stack,
+     * key_extractor and reduce_function.
+     */
+    SortedReduceNode(const ParentDIA& parent,
+                     const char* label,
+                     const KeyExtractor& key_extractor,
+                     const ReduceFunction& reduce_function,
+                     const ReduceConfig& config)
+        : Super(parent.ctx(), label, { parent.id() }, { parent.node() }),
+          key_extractor_(key_extractor),
+          mix_stream_(use_mix_stream_ ?
+                      parent.ctx().GetNewMixStream(this) : nullptr),
+          cat_stream_(use_mix_stream_ ?
+                      nullptr : parent.ctx().GetNewCatStream(this)),
+          local_writers_(MakeLocalWriters(local_file_)),
+          pre_stage_(
+              context_, Super::id(), /* num_partitions */ 1,
+              key_extractor, reduce_function, local_writers_, config),
+          post_stage_(
+              context_, Super::id(), key_extractor, reduce_function,
+              Emitter(this), config)
+    {
+        // Hook PreOp: reduce items locally, the partially reduced items are
+        // written to local_file_ until the splitters are known.
+        auto pre_op_fn = [this](const ValueType& input) {
+                             return pre_stage_.Insert(input);
+                         };
+        // close the function stack with our pre op and register it at
+        // parent node for output
+        auto lop_chain = parent.stack().push(pre_op_fn).fold();
+        parent.node()->AddChild(this, lop_chain);
+    }
+
+    DIAMemUse PreOpMemUse() final {
+        return DIAMemUse::Max();
+    }
+
+    void StartPreOp(size_t /* id */) final {
+        LOG << *this << " running StartPreOp";
+        pre_stage_.Initialize(DIABase::mem_limit_);
+    }
+
+    void StopPreOp(size_t /* id */) final {
+        LOG << *this << " running StopPreOp";
+        // Flush hash table into local_file_
+        pre_stage_.FlushAll();
+        pre_stage_.CloseAll();
+    }
+
+    void Execute() final {
+        MainOp();
+    }
+
+    DIAMemUse PushDataMemUse() final {
+        return DIAMemUse::Max();
+    }
+
+    void PushData(bool consume) final {
+
+        if (!reduced_) {
+            // reduce received items in the post stage and sort them by key
+            size_t limit = DIABase::mem_limit_ / 2;
+            buffer_limit_ = std::max<size_t>(1, limit / sizeof(ValueType));
+            post_stage_.Initialize(limit);
+            ProcessChannel();
+            post_stage_.PushData(/* consume */ true);
+            post_stage_.Dispose();
+
+            if (runs_.empty())
+                std::sort(buffer_.begin(), buffer_.end(), KeyLess(this));
+            else if (!buffer_.empty())
+                SortAndWriteRun();
+
+            reduced_ = true;
+        }
+
+        if (runs_.empty()) {
+            for (const ValueType& v : buffer_)
+                this->PushItem(v);
+            if (consume) std::vector<ValueType>().swap(buffer_);
+        }
+        else if (runs_.size() == 1) {
+            this->PushFile(runs_[0], consume);
+        }
+        else {
+            std::vector<data::File::Reader> readers;
+            readers.reserve(runs_.size());
+            for (data::File& run : runs_)
+                readers.emplace_back(run.GetReader(consume));
+
+            auto puller = core::make_multiway_merge_tree<ValueType>(
+                readers.begin(), readers.end(), KeyLess(this));
+
+            while (puller.HasNext())
+                this->PushItem(puller.Next());
+        }
+    }
+
+    void Dispose() final {
+        post_stage_.Dispose();
+        std::vector<ValueType>().swap(buffer_);
+        runs_.clear();
+    }
+
+private:
+    //! Key extractor function
+    KeyExtractor key_extractor_;
+
+    //! Local File of partially reduced items, written by the pre stage
+    data::File local_file_ { context_.GetFile(this) };
+
+    // pointers for both Mix and CatStream. only one is used, the other costs
+    // only a null pointer.
+    data::MixStreamPtr mix_stream_;
+    data::CatStreamPtr cat_stream_;
+
+    //! single writer of the pre stage into local_file_
+    std::vector<data::DynBlockWriter> local_writers_;
+
+    core::ReducePreStage<
+        ValueType, Key, ValueType, KeyExtractor, ReduceFunction,
+        /* VolatileKey */ false, ReduceConfig> pre_stage_;
+
+    core::ReduceByHashPostStage<
+        ValueType, Key, ValueType, KeyExtractor, ReduceFunction, Emitter,
+        /* SendPair */ false, ReduceConfig> post_stage_;
+
+    //! buffer of reduced items, sorted into runs
+    std::vector<ValueType> buffer_;
+
+    //! maximum number of items in buffer_
+    size_t buffer_limit_ = 1;
+
+    //! sorted runs of reduced items, if buffer_ overflowed
+    std::vector<data::File> runs_;
+
+    bool reduced_ = false;
+
+    //! Comparator of items by their keys.
+    class KeyLess
+    {
+    public:
+        explicit KeyLess(const SortedReduceNode* node) : node_(node) { }
+        bool operator () (const ValueType& a, const ValueType& b) const {
+            return node_->key_extractor_(a) < node_->key_extractor_(b);
+        }
+
+    private:
+        const SortedReduceNode* node_;
+    };
+
+    //! Create the single pre stage writer into file.
+    static std::vector<data::DynBlockWriter> MakeLocalWriters(
+        data::File& file) {
+        std::vector<data::DynBlockWriter> writers;
+        writers.emplace_back(file.GetDynWriter());
+        return writers;
+    }
+
+    //! Collect a reduced item, write a sorted run if the buffer is full.
+    void AddReducedItem(const ValueType& v) {
+        buffer_.push_back(v);
+        if (buffer_.size() >= buffer_limit_)
+            SortAndWriteRun();
+    }
+
+    //! Sort buffer_ by key and write it as a run File.
+    void SortAndWriteRun() {
+        std::sort(buffer_.begin(), buffer_.end(), KeyLess(this));
+
+        runs_.emplace_back(context_.GetFile(this));
+        data::File::Writer writer = runs_.back().GetWriter();
+        for (const ValueType& v : buffer_)
+            writer.Put(v);
+        writer.Close();
+
+        buffer_.clear();
+    }
+
+    /*!
+     * Sample keys from local_file_ and select the global splitters. Each
+     * worker draws a number of samples proportional to its share of all items.
+     * The samples are collected at worker 0, which selects the splitters and
+     * broadcasts them.
+     */
+    std::vector<Key> SelectSplitters() {
+        size_t num_workers = context_.num_workers();
+        size_t local_items = local_file_.num_items();
+        size_t total_items = context_.net.AllReduce(local_items);
+
+        std::vector<Key> splitters;
+        if (total_items == 0) return splitters;
+
+        size_t total_samples = oversampling_factor_ * num_workers *
+                               (1 + common::IntegerLog2Ceil(num_workers));
+        // local share of the samples, rounded up
+        size_t sample_size =
+            (total_samples * local_items + total_items - 1) / total_items;
+        if (sample_size > local_items) sample_size = local_items;
+
+        // send samples to worker 0
+        data::CatStreamPtr sample_stream = context_.GetNewCatStream(this);
+        {
+            std::vector<data::Stream::Writer> writers =
+                sample_stream->GetWriters();
+            std::default_random_engine rng(std::random_device { } ());
+            for (size_t i = 0; i < sample_size; ++i) {
+                writers[0].Put(key_extractor_(
+                                   local_file_.template GetItemAt<ValueType>(
+                                       rng() % local_items)));
+            }
+            for (data::Stream::Writer& w : writers)
+                w.Close();
+        }
+
+        if (context_.my_rank() == 0) {
+            std::vector<Key> samples;
+            auto reader = sample_stream->GetCatReader(/* consume */ true);
+            while (reader.HasNext())
+                samples.emplace_back(reader.template Next<Key>());
+
+            std::sort(samples.begin(), samples.end());
+
+            splitters.reserve(num_workers - 1);
+            for (size_t i = 1; i < num_workers; ++i) {
+                splitters.emplace_back(
+                    samples[i * samples.size() / num_workers]);
+            }
+        }
+        sample_stream->Close();
+
+        return context_.net.Broadcast(splitters);
+    }
+
+    //! Send the partially reduced items to the workers owning their key range.
+    void MainOp() {
+        std::vector<Key> splitters = SelectSplitters();
+
+        LOG << "SortedReduceNode: " << local_file_.num_items()
+            << " partially reduced items, " << splitters.size()
+            << " splitters";
+
+        std::vector<data::Stream::Writer> emitters =
+            use_mix_stream_ ? mix_stream_->GetWriters()
+            : cat_stream_->GetWriters();
+
+        auto reader = local_file_.GetConsumeReader();
+        while (reader.HasNext()) {
+            ValueType v = reader.template Next<ValueType>();
+            size_t worker =
+                std::upper_bound(splitters.begin(), splitters.end(),
+                                 key_extractor_(v)) - splitters.begin();
+            emitters[worker].Put(v);
+        }
+
+        for (data::Stream::Writer& e : emitters)
+            e.Close();
+    }
+
+    //! process the inbound data in the post reduce stage
+    void ProcessChannel() {
+        if (use_mix_stream_)
+        {
+            auto reader = mix_stream_->GetMixReader(/* consume */ true);
+            while (reader.HasNext())
+                post_stage_.Insert(reader.template Next<ValueType>());
+            mix_stream_->Close();
+        }
+        else
+        {
+            auto reader = cat_stream_->GetCatReader(/* consume */ true);
+            while (reader.HasNext())
+                post_stage_.Insert(reader.template Next<ValueType>());
+            cat_stream_->Close();
+        }
+    }
+};
+
+/*!
+ * A DIANode which performs a ReduceByKey operation, but first detects which
+ * keys occur on more than one worker, and only shuffles the items of these.
+ * This saves network volume if most keys are globally unique.
+ *
+ * In the PreOp, items are reduced locally in a single-partition pre stage,
+ * which writes the partially reduced items into a local File. The MainOp
+ * exchanges fingerprints of the local keys with core::DuplicateDetection, then
+ * sends items with possibly duplicate keys to the fingerprint's owner. Items
+ * whose key occurs only once locally and on no other worker are already fully
+ * reduced and are kept in a File, which is pushed without the post stage. The
+ * post stage reduces only the received items.
+ *
+ * \tparam ValueType Output type of the Reduce operation
+ * \tparam ParentDIA Type of the parent DIA.
+ * \tparam KeyExtractor Type of the key_extractor function.
+ * \tparam ReduceFunction Type of the reduce_function.
+ *
+ * \ingroup api_layer
+ */
+template <typename ValueType, typename ParentDIA,
+          typename KeyExtractor, typename ReduceFunction,
+          typename ReduceConfig>
+class DuplicateDetectionReduceNode final : public DOpNode<ValueType>
+{
+    static constexpr bool debug = false;
+
+    using Super = DOpNode<ValueType>;
+    using Super::context_;
+
+    using Key = typename common::FunctionTraits<KeyExtractor>::result_type;
+
+    static constexpr bool use_mix_stream_ = ReduceConfig::use_mix_stream_;
+
+private:
+    //! Emitter for PostStage to push elements to next DIA object.
+    class Emitter
+    {
+    public:
+        explicit Emitter(DuplicateDetectionReduceNode* node) : node_(node) { }
+        void operator () (const ValueType& item) const
+        { return node_->PushItem(item); }
+
+    private:
+        DuplicateDetectionReduceNode* node_;
+    };
+
+public:
+    /*!
+     * Constructor for a DuplicateDetectionReduceNode. Sets the parent, stack,
+     * key_extractor and reduce_function.
+     */
+    DuplicateDetectionReduceNode(const ParentDIA& parent,
+                                 const char* label,
+                                 const KeyExtractor& key_extractor,
+                                 const ReduceFunction& reduce_function,
+                                 const ReduceConfig& config)
+        : Super(parent.ctx(), label, { parent.id() }, { parent.node() }),
+          key_extractor_(key_extractor),
+          mix_stream_(use_mix_stream_ ?
+                      parent.ctx().GetNewMixStream(this) : nullptr),
+          cat_stream_(use_mix_stream_ ?
+                      nullptr : parent.ctx().GetNewCatStream(this)),
+          local_writers_(MakeLocalWriters(local_file_)),
+          pre_stage_(
+              context_, Super::id(), /* num_partitions */ 1,
+              key_extractor, reduce_function, local_writers_, config),
+          post_stage_(
+              context_, Super::id(), key_extractor, reduce_function,
+              Emitter(this), config)
+    {
+        // Hook PreOp: reduce items locally, the partially reduced items are
+        // written to local_file_ until the duplicates are known.
+        auto pre_op_fn = [this](const ValueType& input) {
+                             return pre_stage_.Insert(input);
+                         };
+        // close the function stack with our pre op and register it at
+        // parent node for output
+        auto lop_chain = parent.stack().push(pre_op_fn).fold();
+        parent.node()->AddChild(this, lop_chain);
+    }
+
+    DIAMemUse PreOpMemUse() final {
+        return DIAMemUse::Max();
+    }
+
+    void StartPreOp(size_t /* id */) final {
+        LOG << *this << " running StartPreOp";
+        pre_stage_.Initialize(DIABase::mem_limit_);
+    }
+
+    void StopPreOp(size_t /* id */) final {
+        LOG << *this << " running StopPreOp";
+        // Flush hash table into local_file_
+        pre_stage_.FlushAll();
+        pre_stage_.CloseAll();
+    }
+
+    DIAMemUse ExecuteMemUse() final {
+        return DIAMemUse::Max();
+    }
+
+    void Execute() final {
+        MainOp();
+    }
+
+    DIAMemUse PushDataMemUse() final {
+        return DIAMemUse::Max();
+    }
+
+    void PushData(bool consume) final {
+
+        if (!reduced_) {
+            // reduce the received items in the post stage
+            post_stage_.Initialize(DIABase::mem_limit_);
+            ProcessChannel();
+
+            reduced_ = true;
+        }
+
+        // items with unique keys are fully reduced
+        this->PushFile(unique_file_, consume);
+
+        post_stage_.PushData(consume);
+    }
+
+    void Dispose() final {
+        local_file_.Clear();
+        unique_file_.Clear();
+        post_stage_.Dispose();
+    }
+
+private:
+    //! Key extractor function
+    KeyExtractor key_extractor_;
+
+    //! hash function of the keys
+    std::hash<Key> hash_function_;
+
+    //! Local File of partially reduced items, written by the pre stage
+    data::File local_file_ { context_.GetFile(this) };
+
+    //! Local File of items whose keys occur once on no other worker
+    data::File unique_file_ { context_.GetFile(this) };
+
+    // pointers for both Mix and CatStream. only one is used, the other costs
+    // only a null pointer.
+    data::MixStreamPtr mix_stream_;
+    data::CatStreamPtr cat_stream_;
+
+    //! single writer of the pre stage into local_file_
+    std::vector<data::DynBlockWriter> local_writers_;
+
+    core::ReducePreStage<
+        ValueType, Key, ValueType, KeyExtractor, ReduceFunction,
+        /* VolatileKey */ false, ReduceConfig> pre_stage_;
+
+    core::ReduceByHashPostStage<
+        ValueType, Key, ValueType, KeyExtractor, ReduceFunction, Emitter,
+        /* SendPair */ false, ReduceConfig> post_stage_;
+
+    bool reduced_ = false;
+
+    //! Create the single pre stage writer into file.
+    static std::vector<data::DynBlockWriter> MakeLocalWriters(
+        data::File& file) {
+        std::vector<data::DynBlockWriter> writers;
+        writers.emplace_back(file.GetDynWriter());
+        return writers;
+    }
+
+    //! hash of an item's key, independent of the hash tables' hash
+    uint64_t KeyHash(const ValueType& v) const {
+        return core::Hash128to64(
+            /* salt */ 1, hash_function_(key_extractor_(v)));
+    }
+
+    //! Find duplicate keys, and send only their items to other workers.
+    void MainOp() {
+        size_t num_workers = context_.num_workers();
+
+        // fingerprints of the keys are read directly from local_file_ and
+        // exchanged in runs bounded by the memory limit.
+        core::DuplicateDetection dup_detect;
+        dup_detect.FindDuplicates<ValueType>(
+            context_, Super::id(), local_file_,
+            [this](const ValueType& v) { return KeyHash(v); },
+            DIABase::mem_limit_);
+
+        std::vector<data::Stream::Writer> emitters =
+            use_mix_stream_ ? mix_stream_->GetWriters()
+            : cat_stream_->GetWriters();
+        data::File::Writer unique_writer = unique_file_.GetWriter();
+
+        size_t sent = 0;
+        auto reader = local_file_.GetConsumeReader();
+        while (reader.HasNext()) {
+            ValueType v = reader.template Next<ValueType>();
+            uint64_t hash = KeyHash(v);
+            if (dup_detect.IsDuplicate(hash)) {
+                // reduce all items of the key in the owner's post stage
+                emitters[core::DuplicateDetection::Owner(hash, num_workers)]
+                .Put(v);
+                ++sent;
+            }
+            else {
+                unique_writer.Put(v);
+            }
+        }
+
+        unique_writer.Close();
+        for (data::Stream::Writer& e : emitters)
+            e.Close();
+
+        LOG << "DuplicateDetectionReduceNode: sent " << sent << " items, kept "
+            << unique_file_.num_items() << " items with unique keys";
+    }
+
+    //! process the inbound data in the post reduce stage
+    void ProcessChannel() {
+        if (use_mix_stream_)
+        {
+            auto reader = mix_stream_->GetMixReader(/* consume */ true);
+            while (reader.HasNext())
+                post_stage_.Insert(reader.template Next<ValueType>());
+            mix_stream_->Close();
+        }
+        else
+        {
+            auto reader = cat_stream_->GetCatReader(/* consume */ true);
+            while (reader.HasNext())
+                post_stage_.Insert(reader.template Next<ValueType>());
+            cat_stream_->Close();
+        }
+    }
+};
+
 template <typename ValueType, typename Stack>
 template <typename KeyExtractor, typename ReduceFunction, typename ReduceConfig>
 auto DIA<ValueType, Stack>::ReduceByKey(
@@ -319,6 +892,102 @@ auto DIA<ValueType, Stack>::ReduceByKey(
     return DIA<DOpResult>(node);
 }
 
+template <typename ValueType, typename Stack>
+template <typename KeyExtractor, typename ReduceFunction, typename ReduceConfig>
+auto DIA<ValueType, Stack>::ReduceByKey(
+    struct SortedKeyTag,
+    const KeyExtractor &key_extractor,
+    const ReduceFunction &reduce_function,
+    const ReduceConfig &reduce_config) const {
+    assert(IsValid());
+
+    using DOpResult
+              = typename common::FunctionTraits<ReduceFunction>::result_type;
+
+    static_assert(
+        std::is_convertible<
+            ValueType,
+            typename common::FunctionTraits<ReduceFunction>::template arg<0>
+            >::value,
+        "ReduceFunction has the wrong input type");
+
+    static_assert(
+        std::is_convertible<
+            ValueType,
+            typename common::FunctionTraits<ReduceFunction>::template arg<1>
+            >::value,
+        "ReduceFunction has the wrong input type");
+
+    static_assert(
+        std::is_same<
+            DOpResult,
+            ValueType>::value,
+        "ReduceFunction has the wrong output type");
+
+    static_assert(
+        std::is_same<
+            typename std::decay<typename common::FunctionTraits<KeyExtractor>
+                                ::template arg<0> >::type,
+            ValueType>::value,
+        "KeyExtractor has the wrong input type");
+
+    using SortedReduceNode = api::SortedReduceNode<
+              DOpResult, DIA, KeyExtractor, ReduceFunction, ReduceConfig>;
+
+    auto node = common::MakeCounting<SortedReduceNode>(
+        *this, "ReduceByKey", key_extractor, reduce_function, reduce_config);
+
+    return DIA<DOpResult>(node);
+}
+
+template <typename ValueType, typename Stack>
+template <typename KeyExtractor, typename ReduceFunction, typename ReduceConfig>
+auto DIA<ValueType, Stack>::ReduceByKey(
+    struct DuplicateDetectionTag,
+    const KeyExtractor &key_extractor,
+    const ReduceFunction &reduce_function,
+    const ReduceConfig &reduce_config) const {
+    assert(IsValid());
+
+    using DOpResult
+              = typename common::FunctionTraits<ReduceFunction>::result_type;
+
+    static_assert(
+        std::is_convertible<
+            ValueType,
+            typename common::FunctionTraits<ReduceFunction>::template arg<0>
+            >::value,
+        "ReduceFunction has the wrong input type");
+
+    static_assert(
+        std::is_convertible<
+            ValueType,
+            typename common::FunctionTraits<ReduceFunction>::template arg<1>
+            >::value,
+        "ReduceFunction has the wrong input type");
+
+    static_assert(
+        std::is_same<
+            DOpResult,
+            ValueType>::value,
+        "ReduceFunction has the wrong output type");
+
+    static_assert(
+        std::is_same<
+            typename std::decay<typename common::FunctionTraits<KeyExtractor>
+                                ::template arg<0> >::type,
+            ValueType>::value,
+        "KeyExtractor has the wrong input type");
+
+    using DuplicateDetectionReduceNode = api::DuplicateDetectionReduceNode<
+              DOpResult, DIA, KeyExtractor, ReduceFunction, ReduceConfig>;
+
+    auto node = common::MakeCounting<DuplicateDetectionReduceNode>(
+        *this, "ReduceByKey", key_extractor, reduce_function, reduce_config);
+
+    return DIA<DOpResult>(node);
+}
+
 template <typename ValueType, typename Stack>
 template <typename ReduceFunction, typename ReduceConfig>
 auto DIA<ValueType, Stack>::ReducePair(
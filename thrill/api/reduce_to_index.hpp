@@ -20,6 +20,7 @@
 #include <thrill/api/dop_node.hpp>
 #include <thrill/common/functional.hpp>
 #include <thrill/common/logger.hpp>
+#include <thrill/common/math.hpp>
 #include <thrill/common/meta.hpp>
 #include <thrill/common/porting.hpp>
 #include <thrill/core/reduce_by_index_post_stage.hpp>
@@ -46,6 +47,14 @@ class DefaultReduceToIndexConfig : public core::DefaultReduceConfig
  * the result type of the reduce_function. The key type is an unsigned integer
  * and the output DIA will have element with key K at index K.
  *
+ * If the result array of result_size items fits into the memory limit of all
+ * workers, the node switches to a dense mode: items are reduced locally
+ * directly into a std::vector indexed by key, without any hash tables. If
+ * the items are trivially copyable, the partial arrays are then combined with
+ * a ReduceScatter collective, which leaves each worker with its part of the
+ * result array without serializing items. Otherwise, the set entries of each
+ * index range are sent to the worker owning it via the node's stream.
+ *
  * \tparam ParentType Input type of the Reduce operation
  * \tparam ValueType Output type of the Reduce operation
  * \tparam ParentStack Function stack, which contains the chained lambdas between the last and this DIANode.
@@ -77,6 +86,7 @@ class ReduceToIndexNode final : public DOpNode<ValueType>
 
     static constexpr bool use_mix_stream_ = ReduceConfig::use_mix_stream_;
     static constexpr bool use_post_thread_ = ReduceConfig::use_post_thread_;
+    static constexpr bool use_dense_array_ = ReduceConfig::use_dense_array_;
 
 private:
     //! Emitter for PostStage to push elements to next DIA object.
@@ -110,7 +120,10 @@ public:
                       nullptr : parent.ctx().GetNewCatStream(this)),
           emitters_(use_mix_stream_ ?
                     mix_stream_->GetWriters() : cat_stream_->GetWriters()),
+          key_extractor_(key_extractor),
+          reduce_function_(reduce_function),
           result_size_(result_size),
+          neutral_element_(neutral_element),
           pre_stage_(
               context_, Super::id(), context_.num_workers(),
               key_extractor, reduce_function, emitters_,
@@ -124,6 +137,7 @@ public:
         // reduce each bucket to a single value, afterwards send data to another
         // worker given by the shuffle algorithm.
         auto pre_op_fn = [this](const ValueType& input) {
+                             if (dense_) return DenseInsert(input);
                              return pre_stage_.Insert(input);
                          };
 
@@ -140,7 +154,14 @@ public:
     }
 
     void StartPreOp(size_t /* id */) final {
-        if (!use_post_thread_) {
+        dense_ = UseDenseArray();
+        if (dense_) {
+            LOG << "ReduceToIndex: using dense array of " << result_size_
+                << " items";
+            dense_array_.resize(
+                result_size_, DenseSlot { neutral_element_, false });
+        }
+        else if (!use_post_thread_) {
             // use pre_stage without extra thread
             pre_stage_.Initialize(DIABase::mem_limit_);
 
@@ -167,11 +188,18 @@ public:
 
     void StopPreOp(size_t /* id */) final {
         LOG << *this << " running StopPreOp";
-        // Flush hash table before the postOp
-        pre_stage_.FlushAll();
+        if (dense_) {
+            DenseSendRanges();
+        }
+        else {
+            // Flush hash table before the postOp
+            pre_stage_.FlushAll();
+        }
         pre_stage_.CloseAll();
-        // waiting for the additional thread to finish the reduce
-        if (use_post_thread_) thread_.join();
+        // receive the local range of the dense array, or wait for the
+        // additional thread to finish the reduce
+        if (dense_) DenseReceiveRanges();
+        else if (use_post_thread_) thread_.join();
         use_mix_stream_ ? mix_stream_->Close() : cat_stream_->Close();
     }
 
@@ -183,6 +211,14 @@ public:
 
     void PushData(bool consume) final {
 
+        if (dense_) {
+            for (const DenseSlot& slot : dense_array_) {
+                this->PushItem(slot.set ? slot.value : neutral_element_);
+            }
+            if (consume) DenseDispose();
+            return;
+        }
+
         if (!use_post_thread_ && !reduced_) {
             // not final reduced, and no additional thread, perform post reduce
             post_stage_.Initialize(DIABase::mem_limit_);
@@ -217,6 +253,7 @@ public:
 
     void Dispose() final {
         post_stage_.Dispose();
+        DenseDispose();
     }
 
 private:
@@ -227,8 +264,32 @@ private:
 
     std::vector<data::Stream::Writer> emitters_;
 
+    KeyExtractor key_extractor_;
+    ReduceFunction reduce_function_;
+
     size_t result_size_;
 
+    //! value of indexes which received no items
+    Value neutral_element_;
+
+    //! whether the dense array mode is used, determined in StartPreOp().
+    bool dense_ = false;
+
+    //! cell of the dense array: the partial result and whether an item was
+    //! reduced into it. It is trivially copyable if Value is.
+    struct DenseSlot {
+        Value value;
+        bool  set;
+    };
+
+    //! whether the dense arrays are combined with a ReduceScatter collective
+    static constexpr bool dense_reduce_scatter_ =
+        std::is_trivially_copyable<Value>::value;
+
+    //! dense array of partial results, indexed by key. After the PreOp, it
+    //! only contains the local range of keys.
+    std::vector<DenseSlot> dense_array_;
+
     //! handle to additional thread for post stage
     std::thread thread_;
 
@@ -241,6 +302,106 @@ private:
         ReduceConfig> post_stage_;
 
     bool reduced_ = false;
+
+    //! Decide whether the dense result array fits into the memory limit on
+    //! all workers.
+    bool UseDenseArray() {
+        if (!use_dense_array_) return false;
+        size_t fits =
+            result_size_ * sizeof(DenseSlot) <= DIABase::mem_limit_ / 2 ? 1 : 0;
+        return context_.net.AllReduce(fits, common::minimum<size_t>()) != 0;
+    }
+
+    //! Range of keys reduced by worker in dense mode, which is the range
+    //! scattered to it by ReduceScatter().
+    common::Range DenseRange(size_t worker) const {
+        return context_.net.ReduceScatterRange(result_size_, worker);
+    }
+
+    //! Reduce item into the dense array.
+    void DenseInsert(const ValueType& input) {
+        const Key key = key_extractor_(input);
+        assert(key < result_size_ && "Item out of range.");
+        DenseSlot& slot = dense_array_[key];
+        if (slot.set) {
+            slot.value = reduce_function_(slot.value, input);
+        }
+        else {
+            slot.value = input;
+            slot.set = true;
+        }
+    }
+
+    //! Combine the dense arrays of all workers, such that each keeps only its
+    //! reduced local range.
+    void DenseSendRanges() {
+        DenseSendRanges(
+            std::integral_constant<bool, dense_reduce_scatter_>());
+    }
+
+    //! Combine trivially copyable dense arrays with a ReduceScatter.
+    void DenseSendRanges(std::true_type /* reduce_scatter */) {
+        dense_array_ = context_.net.ReduceScatter(
+            std::move(dense_array_),
+            [this](const DenseSlot& a, const DenseSlot& b) {
+                if (!a.set) return b;
+                if (!b.set) return a;
+                return DenseSlot { reduce_function_(a.value, b.value), true };
+            });
+    }
+
+    //! Send the set entries of all other workers' ranges to them, and keep only
+    //! the local range.
+    void DenseSendRanges(std::false_type /* reduce_scatter */) {
+        const size_t my_rank = context_.my_rank();
+        for (size_t w = 0; w < context_.num_workers(); ++w) {
+            if (w == my_rank) continue;
+            common::Range range = DenseRange(w);
+            for (size_t k = range.begin; k < range.end; ++k) {
+                if (!dense_array_[k].set) continue;
+                emitters_[w].Put(KeyValuePair(k, dense_array_[k].value));
+            }
+        }
+
+        common::Range range = DenseRange(my_rank);
+        std::vector<DenseSlot>(dense_array_.begin() + range.begin,
+                               dense_array_.begin() + range.end)
+        .swap(dense_array_);
+    }
+
+    //! Reduce the items of the local range received from other workers, which
+    //! are none if the ReduceScatter was used.
+    void DenseReceiveRanges() {
+        if (use_mix_stream_) {
+            auto reader = mix_stream_->GetMixReader(/* consume */ true);
+            DenseReduceReader(reader);
+        }
+        else {
+            auto reader = cat_stream_->GetCatReader(/* consume */ true);
+            DenseReduceReader(reader);
+        }
+    }
+
+    template <typename Reader>
+    void DenseReduceReader(Reader& reader) {
+        const size_t begin = DenseRange(context_.my_rank()).begin;
+        while (reader.HasNext()) {
+            KeyValuePair kv = reader.template Next<KeyValuePair>();
+            DenseSlot& slot = dense_array_[kv.first - begin];
+            if (slot.set) {
+                slot.value = reduce_function_(slot.value, kv.second);
+            }
+            else {
+                slot.value = std::move(kv.second);
+                slot.set = true;
+            }
+        }
+    }
+
+    //! Deallocate the dense array.
+    void DenseDispose() {
+        std::vector<DenseSlot>().swap(dense_array_);
+    }
 };
 
 template <typename ValueType, typename Stack>
@@ -20,6 +20,8 @@
 #include <thrill/common/logger.hpp>
 #include <thrill/common/math.hpp>
 #include <thrill/common/porting.hpp>
+#include <thrill/common/thread_pool.hpp>
+#include <thrill/core/multikey_quicksort.hpp>
 #include <thrill/core/multiway_merge.hpp>
 #include <thrill/data/file.hpp>
 #include <thrill/net/group.hpp>
@@ -27,8 +29,13 @@
 #include <algorithm>
 #include <cstdlib>
 #include <deque>
+#include <exception>
 #include <functional>
+#include <iterator>
+#include <numeric>
 #include <random>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -80,6 +87,7 @@ public:
 
     void PreOp(const ValueType& input) {
         unsorted_writer_.Put(input);
+        if (count_descents_in_preop_) CountDescent(input);
         local_items_++;
         // In this stage we do not know how many elements are there in total.
         // Therefore we draw samples based on current number of elements and
@@ -106,6 +114,10 @@ public:
         unsorted_file_ = file.Copy();
         local_items_ = unsorted_file_.num_items();
 
+        // scan the File for presortedness, e.g. if it is the output of
+        // another Sort.
+        ScanDescents();
+
         size_t pick_items = std::min(local_items_, wanted_sample_size());
 
         sLOG << "Pick" << pick_items << "samples by random access"
@@ -122,6 +134,10 @@ public:
     void StopPreOp(size_t /* id */) final {
         unsorted_writer_.Close();
 
+        // scan the written items, unless PreOp() or OnPreOpFile() did.
+        if (!count_descents_in_preop_ && local_bounds_.empty())
+            ScanDescents();
+
         LOG << "wanted_sample_size()=" << wanted_sample_size()
             << " samples.size()= " << samples_.size();
     }
@@ -149,7 +165,9 @@ public:
     //! calculate maximum merging degree from available memory and the number of
     //! files. additionally calculate the prefetch size of each File.
     std::pair<size_t, size_t> MaxMergeDegreePrefetch() {
-        size_t avail_blocks = DIABase::mem_limit_ / data::default_block_size;
+        // each merge thread reads from all Files
+        size_t avail_blocks =
+            DIABase::mem_limit_ / data::default_block_size / merge_threads_;
         if (files_.size() >= avail_blocks) {
             // more files than blocks available -> partial merge of avail_blocks
             // Files with prefetch = 0, which is one read Block per File.
@@ -174,37 +192,57 @@ public:
         else {
             size_t merge_degree, prefetch;
 
+            merge_threads_ = MergeThreads();
+
             // merge batches of files if necessary
             while (files_.size() > MaxMergeDegreePrefetch().first)
             {
                 std::tie(merge_degree, prefetch) = MaxMergeDegreePrefetch();
 
                 sLOG1 << "Partial multi-way-merge of"
-                      << merge_degree << "files with prefetch" << prefetch;
+                      << merge_degree << "files with prefetch" << prefetch
+                      << "using" << merge_threads_ << "threads";
 
-                // create merger for first merge_degree_ Files
-                std::vector<data::File::ConsumeReader> seq;
-                seq.reserve(merge_degree);
+                // create new File for merged items
+                files_.emplace_back(context_.GetFile(this));
+                files_.back().SetEvictionHint(data::EvictionHint::ReadOnce);
+
+                if (merge_threads_ > 1) {
+                    // merge disjoint key ranges in parallel into part Files
+                    std::vector<data::File> parts;
+                    for (size_t p = 0; p < merge_threads_; ++p) {
+                        parts.emplace_back(context_.GetFile(this));
+                        parts.back().SetEvictionHint(
+                            data::EvictionHint::ReadOnce);
+                    }
+
+                    core::parallel_multiway_merge_files<ValueType>(
+                        files_.begin(), files_.begin() + merge_degree,
+                        parts, prefetch, compare_function_, files_.back());
+                }
+                else {
+                    // create merger for first merge_degree_ Files
+                    std::vector<data::File::ConsumeReader> seq;
+                    seq.reserve(merge_degree);
 
-                for (size_t t = 0; t < merge_degree; ++t)
-                    seq.emplace_back(files_[t].GetConsumeReader(0));
+                    for (size_t t = 0; t < merge_degree; ++t)
+                        seq.emplace_back(files_[t].GetConsumeReader(0));
 
-                StartPrefetch(seq, prefetch);
+                    StartPrefetch(seq, prefetch);
 
-                auto puller = core::make_multiway_merge_tree<ValueType>(
-                    seq.begin(), seq.end(), compare_function_);
+                    auto puller = core::make_multiway_merge_tree<ValueType>(
+                        seq.begin(), seq.end(), compare_function_);
 
-                // create new File for merged items
-                files_.emplace_back(context_.GetFile(this));
-                auto writer = files_.back().GetWriter();
+                    auto writer = files_.back().GetWriter();
+                    while (puller.HasNext()) {
+                        writer.Put(puller.Next());
+                    }
+                    writer.Close();
 
-                while (puller.HasNext()) {
-                    writer.Put(puller.Next());
+                    // this clear is important to release references to the
+                    // files.
+                    seq.clear();
                 }
-                writer.Close();
-
-                // this clear is important to release references to the files.
-                seq.clear();
 
                 // remove merged files
                 files_.erase(files_.begin(), files_.begin() + merge_degree);
@@ -213,7 +251,13 @@ public:
             std::tie(merge_degree, prefetch) = MaxMergeDegreePrefetch();
 
             sLOG1 << "Start multi-way-merge of" << files_.size() << "files"
-                  << "with prefetch" << prefetch;
+                  << "with prefetch" << prefetch
+                  << "using" << merge_threads_ << "threads";
+
+            if (merge_threads_ > 1) {
+                ParallelMergeAndPush(prefetch);
+                return;
+            }
 
             // construct output merger of remaining Files
             std::vector<data::File::ConsumeReader> seq;
@@ -233,6 +277,9 @@ public:
         }
     }
 
+    //! Returns the number of sorted runs written while receiving the items.
+    size_t num_runs() const { return num_runs_; }
+
 private:
     //! The comparison function which is applied to two elements.
     CompareFunction compare_function_;
@@ -247,6 +294,11 @@ private:
     //! Number of items on this worker
     size_t local_items_ = 0;
 
+    //! Number of local items which are less than their predecessor
+    size_t local_descents_ = 0;
+    //! First and last local item, or empty if there are no local items
+    std::vector<ValueType> local_bounds_;
+
     //! Sample vector
     std::vector<ValueType> samples_;
     //! Number of items to process before the next sample was drawn
@@ -257,6 +309,60 @@ private:
     //! epsilon
     static constexpr double desired_imbalance_ = 0.3;
 
+    //! Whether PreOp() counts descents item by item, which requires a copy of
+    //! the last item. Other types are scanned in StopPreOp() instead, which
+    //! moves the items read from the File.
+    static constexpr bool count_descents_in_preop_ =
+        std::is_trivially_copyable<ValueType>::value;
+
+    //! Count the item if it is less than its predecessor, and remember it as
+    //! the last local item.
+    void CountDescent(const ValueType& input) {
+        if (local_bounds_.empty()) {
+            local_bounds_.push_back(input);
+            local_bounds_.push_back(input);
+            return;
+        }
+        if (compare_function_(input, local_bounds_[1]))
+            ++local_descents_;
+        local_bounds_[1] = input;
+    }
+
+    //! Count the descents in unsorted_file_ and remember its first and last
+    //! item, but only if this requires no extra reads from disk. Otherwise the
+    //! File is assumed not to be sorted.
+    void ScanDescents() {
+        if (local_items_ == 0) return;
+
+        if (InMemory(unsorted_file_)) {
+            auto reader = unsorted_file_.GetKeepReader();
+            ValueType last = reader.template Next<ValueType>();
+            local_bounds_.push_back(last);
+            while (reader.HasNext()) {
+                ValueType item = reader.template Next<ValueType>();
+                if (compare_function_(item, last))
+                    ++local_descents_;
+                last = std::move(item);
+            }
+            local_bounds_.push_back(std::move(last));
+        }
+        else {
+            // assume that the File is not sorted.
+            local_descents_ = 1;
+            local_bounds_.push_back(unsorted_file_.GetItemAt<ValueType>(0));
+            local_bounds_.push_back(
+                unsorted_file_.GetItemAt<ValueType>(local_items_ - 1));
+        }
+    }
+
+    //! Returns true if all Blocks of the File reside in memory.
+    static bool InMemory(const data::File& file) {
+        for (const data::Block& b : file.blocks()) {
+            if (!b.byte_block()->in_memory()) return false;
+        }
+        return true;
+    }
+
     //! calculate currently desired number of samples
     size_t wanted_sample_size() const {
         size_t s = static_cast<size_t>(
@@ -267,11 +373,129 @@ private:
 
     //! \}
 
+    //! items at least this large are sorted via index tags
+    static constexpr size_t tag_sort_min_size_ = 64;
+
+    //! Sort runs of large items, such as 100-byte records, by sorting an array
+    //! of their indexes (tags) and writing the items in tag order. This avoids
+    //! moving the items during sorting.
+    static constexpr bool use_tag_sort_ =
+        sizeof(ValueType) >= tag_sort_min_size_;
+
     //! Local data files
     std::deque<data::File> files_;
+    //! Number of sorted runs written into files_
+    size_t num_runs_ = 0;
     //! Total number of local elements after communication
     size_t local_out_size_ = 0;
 
+    //! \name PushData Phase
+    //! \{
+
+    //! minimum number of items per thread to merge in parallel
+    static constexpr size_t parallel_merge_min_items_ = 1024 * 1024;
+
+    //! number of threads used to merge the sorted Files
+    size_t merge_threads_ = 1;
+
+    //! Calculate the number of merge threads: the cores not used by other
+    //! workers on the host, hence one with the default of one worker per core,
+    //! limited by the available memory and such that each thread merges enough
+    //! items. Since each thread reads from all Files, more threads reduce the
+    //! merge degree, hence they are only used if this does not increase the
+    //! number of items written by partial merges.
+    size_t MergeThreads() const {
+        size_t threads =
+            std::thread::hardware_concurrency() / context_.workers_per_host();
+
+        size_t avail_blocks = DIABase::mem_limit_ / data::default_block_size;
+        threads = std::min(threads, avail_blocks / 4);
+
+        size_t total_items = 0;
+        for (const data::File& file : files_)
+            total_items += file.num_items();
+        threads = std::min(threads, total_items / parallel_merge_min_items_);
+
+        if (threads <= 1) return 1;
+
+        size_t volume = PartialMergeVolume(avail_blocks);
+        while (threads > 1 &&
+               PartialMergeVolume(avail_blocks / threads) > volume)
+            --threads;
+
+        return threads;
+    }
+
+    //! Calculate the number of items written by partial merges, if the Files
+    //! are merged with the given maximum degree like in PushData().
+    size_t PartialMergeVolume(size_t merge_degree) const {
+        assert(merge_degree >= 2);
+        std::deque<size_t> sizes;
+        for (const data::File& file : files_)
+            sizes.push_back(file.num_items());
+
+        size_t volume = 0;
+        while (sizes.size() > merge_degree) {
+            size_t merged = 0;
+            for (size_t i = 0; i < merge_degree; ++i) {
+                merged += sizes.front();
+                sizes.pop_front();
+            }
+            sizes.push_back(merged);
+            volume += merged;
+        }
+        return volume;
+    }
+
+    /*!
+     * Merge the Files in parallel: the key space is split into merge_threads_
+     * ranges, the first of which is merged and pushed by this thread, while
+     * the other threads merge their range into part Files, which are pushed
+     * afterwards.
+     */
+    void ParallelMergeAndPush(size_t prefetch) {
+        std::vector<std::vector<size_t> > bounds =
+            core::multiway_merge_split_files<ValueType>(
+                files_.begin(), files_.end(), merge_threads_,
+                compare_function_);
+
+        // each thread consumes the Blocks of its range
+        std::vector<std::vector<core::MultiwayMergeFilePart> > inputs =
+            core::multiway_merge_take_parts(
+                files_.begin(), files_.end(), bounds, merge_threads_);
+        files_.clear();
+
+        std::vector<data::File> parts;
+        for (size_t p = 0; p < merge_threads_; ++p) {
+            parts.emplace_back(context_.GetFile(this));
+            parts.back().SetEvictionHint(data::EvictionHint::ReadOnce);
+        }
+
+        std::vector<std::thread> threads;
+        for (size_t p = 1; p < merge_threads_; ++p) {
+            threads.emplace_back(common::CreateThread(
+                                     [this, &inputs, &parts, p, prefetch]() {
+                    data::File::Writer writer = parts[p].GetWriter();
+                    core::multiway_merge_file_part<ValueType>(
+                        inputs[p], prefetch, compare_function_,
+                        [&writer](const ValueType& v) { writer.Put(v); });
+                    writer.Close();
+                }));
+        }
+
+        core::multiway_merge_file_part<ValueType>(
+            inputs[0], prefetch, compare_function_,
+            [this](const ValueType& v) { this->PushItem(v); });
+
+        for (std::thread& t : threads)
+            t.join();
+
+        for (size_t p = 1; p < merge_threads_; ++p)
+            this->PushFile(parts[p], /* consume */ true);
+    }
+
+    //! \}
+
     void FindAndSendSplitters(
         std::vector<ValueType>& splitters, size_t sample_size,
         data::MixStreamPtr& sample_stream,
@@ -351,12 +575,19 @@ private:
         return !(compare_function_(ele1, ele2) || compare_function_(ele2, ele1));
     }
 
-    //! round n down by k where k is a power of two.
-    template <typename Integral>
-    static inline size_t RoundDown(Integral n, Integral k) {
-        return (n & ~(k - 1));
-    }
+    //! number of items classified together: their descents of the splitter
+    //! tree are independent, hence the CPU can overlap them.
+    static constexpr size_t classify_unroll_ = 16;
 
+    /*!
+     * Classify all local items by the splitters and transmit them to their
+     * target workers. Items are classified in batches in the style of
+     * super-scalar sample sort: all items of a batch descend the implicit
+     * splitter tree in lockstep without branches, and their bucket ids are
+     * stored in an oracle array. Items equal to their lower splitter fall
+     * into an equality bucket, and are spread over the range of workers
+     * whose splitters are equal to the item by their global rank.
+     */
     void TransmitItems(
         // Tree of splitters, sizeof |splitter|
         const ValueType* const tree,
@@ -376,100 +607,177 @@ private:
         std::vector<data::MixStream::Writer> data_writers =
             data_stream->GetWriters();
 
-        // enlarge emitters array to next power of two to have direct access,
-        // because we fill the splitter set up with sentinels == last splitter,
-        // hence all items land in the last bucket.
         assert(data_writers.size() == actual_k);
         assert(actual_k <= k);
 
-        while (data_writers.size() < k)
-            data_writers.emplace_back(nullptr);
-
-        std::swap(data_writers[actual_k - 1], data_writers[k - 1]);
-
-        // classify all items (take two at once) and immediately transmit them.
+        // for each bucket b: the lowest bucket to which an item equal to
+        // splitter b - 1 may be sent, which is the first of the run of equal
+        // splitters. Splitters are filled up with sentinels equal to the last
+        // splitter.
+        std::vector<size_t> equal_begin(k, 0);
+        for (size_t b = 2; b < k; ++b) {
+            equal_begin[b] =
+                Equal(sorted_splitters[b - 2], sorted_splitters[b - 1])
+                ? equal_begin[b - 1] : b - 1;
+        }
 
-        const size_t stepsize = 2;
+        std::vector<ValueType> batch;
+        batch.reserve(classify_unroll_);
+        size_t oracle[classify_unroll_];
 
-        size_t i = 0;
-        for ( ; i < RoundDown(local_items_, stepsize); i += stepsize)
+        for (size_t i = 0; i < local_items_; i += batch.size())
         {
-            // take two items
-            size_t j0 = 1;
-            ValueType el0 = unsorted_reader.Next<ValueType>();
+            size_t n = local_items_ - i;
+            if (n > classify_unroll_) n = classify_unroll_;
 
-            size_t j1 = 1;
-            ValueType el1 = unsorted_reader.Next<ValueType>();
+            batch.clear();
+            for (size_t t = 0; t < n; ++t)
+                batch.emplace_back(unsorted_reader.Next<ValueType>());
 
-            // run items down the tree
-            for (size_t l = 0; l < log_k; l++)
-            {
-                j0 = 2 * j0 + (compare_function_(el0, tree[j0]) ? 0 : 1);
-                j1 = 2 * j1 + (compare_function_(el1, tree[j1]) ? 0 : 1);
-            }
-
-            size_t b0 = j0 - k;
-            size_t b1 = j1 - k;
-
-            if (b0 && Equal(el0, sorted_splitters[b0 - 1])) {
-                while (b0 && Equal(el0, sorted_splitters[b0 - 1]) &&
-                       (prefix_items + i) * actual_k < b0 * total_items) {
-                    b0--;
-                }
+            // run items down the tree in lockstep
+            for (size_t t = 0; t < n; ++t)
+                oracle[t] = 1;
 
-                if (b0 + 1 >= actual_k) {
-                    b0 = k - 1;
+            for (size_t l = 0; l < log_k; l++) {
+                for (size_t t = 0; t < n; ++t) {
+                    oracle[t] = 2 * oracle[t] + static_cast<size_t>(
+                        !compare_function_(batch[t], tree[oracle[t]]));
                 }
             }
 
-            if (b1 && Equal(el1, sorted_splitters[b1 - 1])) {
-                while (b1 && Equal(el1, sorted_splitters[b1 - 1]) &&
-                       (prefix_items + i + 1) * actual_k < b1 * total_items) {
-                    b1--;
-                }
+            for (size_t t = 0; t < n; ++t) {
+                size_t b = oracle[t] - k;
 
-                if (b1 + 1 >= actual_k) {
-                    b1 = k - 1;
+                // equality bucket: the item is equal to splitter b - 1.
+                if (b && !compare_function_(sorted_splitters[b - 1],
+                                            batch[t])) {
+                    size_t rank_bucket =
+                        (prefix_items + i + t) * actual_k / total_items;
+                    b = std::max(equal_begin[b], std::min(b, rank_bucket));
                 }
-            }
 
-            assert(data_writers[b0].IsValid());
-            assert(data_writers[b1].IsValid());
-
-            data_writers[b0].Put(el0);
-            data_writers[b1].Put(el1);
+                // buckets beyond the actual workers contain only items
+                // greater or equal to the last splitter.
+                data_writers[std::min(b, actual_k - 1)].Put(batch[t]);
+            }
         }
 
-        // last iteration of loop if we have an odd number of items.
-        for ( ; i < local_items_; i++)
-        {
-            size_t j0 = 1;
-            ValueType el0 = unsorted_reader.Next<ValueType>();
+        // close writers and flush data
+        for (size_t j = 0; j < data_writers.size(); j++)
+            data_writers[j].Close();
+    }
 
-            // run item down the tree
-            for (size_t l = 0; l < log_k; l++)
-            {
-                j0 = 2 * j0 + (compare_function_(el0, tree[j0]) ? 0 : 1);
-            }
+    //! runs with at most one descent per this many items are presorted
+    static constexpr size_t presorted_descent_ratio_ = 64;
 
-            size_t b0 = j0 - k;
+    //! extra RAM per presorted_descent_ratio_ items of NaturalMergeSort(): one
+    //! item of merge buffer and two run boundaries.
+    static constexpr size_t natural_merge_overhead_ =
+        sizeof(ValueType) + 2 * sizeof(size_t);
 
-            while (b0 && Equal(el0, sorted_splitters[b0 - 1])
-                   && (prefix_items + i) * actual_k < b0 * total_items) {
-                b0--;
+    /*!
+     * Sort vec adaptively if it consists of few ascending runs, by merging the
+     * runs pairwise with MergeAdaptive(). The merge buffer and the run
+     * boundaries use at most natural_merge_overhead_ bytes per
+     * presorted_descent_ratio_ items. Returns false without modifying vec if
+     * it has too many descents.
+     */
+    bool NaturalMergeSort(std::vector<ValueType>& vec) {
+        std::vector<size_t> runs { 0 };
+        size_t max_runs = vec.size() / presorted_descent_ratio_ + 1;
+        for (size_t i = 1; i < vec.size(); ++i) {
+            if (compare_function_(vec[i], vec[i - 1])) {
+                if (runs.size() >= max_runs) return false;
+                runs.push_back(i);
             }
-
-            if (b0 + 1 >= actual_k) {
-                b0 = k - 1;
+        }
+        runs.push_back(vec.size());
+        if (runs.size() <= 2) return true;
+
+        std::vector<ValueType> buffer;
+        buffer.reserve(max_runs);
+
+        // merge pairs of adjacent runs until one is left
+        while (runs.size() > 2) {
+            std::vector<size_t> merged { 0 };
+            size_t r = 0;
+            for ( ; r + 2 < runs.size(); r += 2) {
+                MergeAdaptive(vec.begin() + runs[r],
+                              vec.begin() + runs[r + 1],
+                              vec.begin() + runs[r + 2], buffer);
+                merged.push_back(runs[r + 2]);
             }
+            // odd number of runs: the last one is carried over
+            if (r + 1 < runs.size())
+                merged.push_back(runs.back());
+            runs.swap(merged);
+        }
+        return true;
+    }
 
-            assert(data_writers[b0].IsValid());
-            data_writers[b0].Put(el0);
+    /*!
+     * Merge the adjacent sorted ranges [first,middle) and [middle,last) in
+     * place. If the shorter range fits into the capacity of buffer, it is
+     * moved there and merged back. Otherwise, both ranges are split by a
+     * binary search and the middle parts are swapped by a rotation, like
+     * std::inplace_merge does without a large enough buffer. In contrast to
+     * std::inplace_merge, this never allocates memory.
+     */
+    template <typename Iterator>
+    void MergeAdaptive(Iterator first, Iterator middle, Iterator last,
+                       std::vector<ValueType>& buffer) {
+        const size_t len1 = middle - first, len2 = last - middle;
+        if (len1 == 0 || len2 == 0) return;
+
+        if (len1 + len2 == 2) {
+            if (compare_function_(*middle, *first))
+                std::iter_swap(first, middle);
+            return;
         }
 
-        // close writers and flush data
-        for (size_t j = 0; j < data_writers.size(); j++)
-            data_writers[j].Close();
+        if (len1 <= buffer.capacity() && len1 <= len2) {
+            // move left range into buffer, merge forward
+            buffer.assign(std::make_move_iterator(first),
+                          std::make_move_iterator(middle));
+            auto b = buffer.begin();
+            while (b != buffer.end() && middle != last) {
+                if (compare_function_(*middle, *b))
+                    *first++ = std::move(*middle++);
+                else
+                    *first++ = std::move(*b++);
+            }
+            std::move(b, buffer.end(), first);
+        }
+        else if (len2 <= buffer.capacity()) {
+            // move right range into buffer, merge backward
+            buffer.assign(std::make_move_iterator(middle),
+                          std::make_move_iterator(last));
+            auto b = buffer.end();
+            while (b != buffer.begin() && middle != first) {
+                if (compare_function_(*(b - 1), *(middle - 1)))
+                    *--last = std::move(*--middle);
+                else
+                    *--last = std::move(*--b);
+            }
+            std::move_backward(buffer.begin(), b, last);
+        }
+        else {
+            Iterator cut1, cut2;
+            if (len1 > len2) {
+                cut1 = first + len1 / 2;
+                cut2 = std::lower_bound(
+                    middle, last, *cut1, compare_function_);
+            }
+            else {
+                cut2 = middle + len2 / 2;
+                cut1 = std::upper_bound(
+                    first, middle, *cut2, compare_function_);
+            }
+            Iterator new_middle = std::rotate(cut1, middle, cut2);
+            MergeAdaptive(first, cut1, new_middle, buffer);
+            MergeAdaptive(new_middle, cut2, last, buffer);
+        }
+        buffer.clear();
     }
 
     void SortAndWriteToFile(
@@ -485,17 +793,45 @@ private:
         context_.block_pool().AdviseFree(vec.size() * sizeof(ValueType));
 
         common::StatsTimerStart sort_time;
-        std::sort(vec.begin(), vec.end(), compare_function_);
+        std::vector<size_t> tags;
+        if (NaturalMergeSort(vec)) {
+            // run was presorted
+        }
+        else if (use_tag_sort_) {
+            // sort indexes of large items instead of moving the items
+            tags.resize(vec.size());
+            std::iota(tags.begin(), tags.end(), size_t(0));
+            std::sort(tags.begin(), tags.end(),
+                      [this, &vec](const size_t& a, const size_t& b) {
+                          return compare_function_(vec[a], vec[b]);
+                      });
+        }
+        else {
+            // std::strings are sorted with multikey quicksort
+            core::SortItems(vec.data(), vec.data() + vec.size(),
+                            compare_function_);
+        }
         sort_time.Stop();
 
         LOG << "SortAndWriteToFile() sort took " << time;
 
         common::StatsTimerStart write_time;
 
+        ++num_runs_;
         files.emplace_back(context_.GetFile(this));
+        // runs are merged from the front and then discarded
+        files.back().SetEvictionHint(data::EvictionHint::ReadOnce);
         auto writer = files.back().GetWriter();
-        for (const ValueType& elem : vec) {
-            writer.Put(elem);
+        if (!tags.empty()) {
+            // write items in the order of the sorted tags
+            for (const size_t& t : tags) {
+                writer.Put(vec[t]);
+            }
+        }
+        else {
+            for (const ValueType& elem : vec) {
+                writer.Put(elem);
+            }
         }
         writer.Close();
 
@@ -516,7 +852,51 @@ private:
             << "write_time" << write_time;
     }
 
+    /*!
+     * Check whether the DIA is already globally sorted: all workers' items are
+     * locally sorted and the first item of each worker is not less than the
+     * last item of the preceding workers. The check is an ordered AllReduce of
+     * the local boundary items.
+     */
+    bool IsGloballySorted() {
+        // (sorted, { first item, last item }) of a range of workers
+        using Bounds = std::pair<bool, std::vector<ValueType> >;
+
+        Bounds bounds = context_.net.AllReduce(
+            Bounds(local_descents_ == 0, local_bounds_),
+            [this](const Bounds& a, const Bounds& b) {
+                if (a.second.empty()) return b;
+                if (b.second.empty()) return a;
+                return Bounds(
+                    a.first && b.first &&
+                    !compare_function_(b.second[0], a.second[1]),
+                    std::vector<ValueType>{ a.second[0], b.second[1] });
+            });
+
+        std::vector<ValueType>().swap(local_bounds_);
+        return bounds.first;
+    }
+
     void MainOp() {
+        if (IsGloballySorted()) {
+            // no need to sample, shuffle, and sort: the local items are the
+            // only run.
+            LOG << "Sort: input is already globally sorted";
+            local_out_size_ = local_items_;
+            if (local_items_ != 0)
+                files_.emplace_back(unsorted_file_.Copy());
+            unsorted_file_.Clear();
+            std::vector<ValueType>().swap(samples_);
+
+            Super::logger_
+                << "class" << "SortNode"
+                << "event" << "done"
+                << "workers" << context_.num_workers()
+                << "local_out_size" << local_out_size_
+                << "presorted" << true;
+            return;
+        }
+
         size_t prefix_items = context_.net.ExPrefixSum(local_items_);
         size_t total_items = context_.net.AllReduce(local_items_);
 
@@ -580,10 +960,16 @@ private:
 
         data::MixStreamPtr data_stream = context_.GetNewMixStream(this);
 
-        // launch receiver thread.
+        // launch receiver thread, its exceptions are rethrown in this thread.
+        std::exception_ptr receive_error;
         std::thread thread = common::CreateThread(
-            [this, &data_stream]() {
-                return ReceiveItems(data_stream);
+            [this, &data_stream, &receive_error]() {
+                try {
+                    ReceiveItems(data_stream);
+                }
+                catch (...) {
+                    receive_error = std::current_exception();
+                }
             });
 
         TransmitItems(
@@ -602,6 +988,9 @@ private:
 
         data_stream->Close();
 
+        if (receive_error)
+            std::rethrow_exception(receive_error);
+
         double balance = 0;
         if (local_out_size_ > 0) {
             balance = static_cast<double>(local_out_size_)
@@ -622,26 +1011,86 @@ private:
             << "sample_size" << samples_.size();
     }
 
+    //! Blocks of the memory limit reserved for reading the stream and for the
+    //! background run writer during run formation.
+    static constexpr size_t run_formation_blocks_ = 4;
+
+    //! runs are flushed early under memory pressure, but not before reaching
+    //! this fraction of the buffer capacity.
+    static constexpr size_t min_run_fraction_ = 16;
+
+    /*!
+     * Receive items into runs, which are sorted and written to files_. Run
+     * formation is double-buffered: while one buffer is sorted and written by
+     * a persistent background thread, the other is filled from the stream,
+     * such that senders are not blocked while sorting. If sorting or writing
+     * fails, the stream is drained and the exception is rethrown.
+     */
     void ReceiveItems(data::MixStreamPtr& data_stream) {
 
         auto reader = data_stream->GetMixReader(/* consume */ true);
 
         LOG << "Writing files";
 
-        // M/2 such that the other half is used to prepare the next bulk
-        size_t capacity = DIABase::mem_limit_ / sizeof(ValueType) / 2;
-        std::vector<ValueType> temp_data;
+        // half of the remaining memory for each of the two buffers, including
+        // the RAM needed by NaturalMergeSort() for presorted runs.
+        size_t reserved = run_formation_blocks_ * data::default_block_size;
+        size_t buffer_mem = DIABase::mem_limit_ > reserved
+                            ? (DIABase::mem_limit_ - reserved) / 2 : 0;
+        size_t item_size =
+            sizeof(ValueType) + (use_tag_sort_ ? sizeof(size_t) : 0);
+        size_t capacity = std::max<size_t>(
+            1, buffer_mem * presorted_descent_ratio_
+            / (item_size * presorted_descent_ratio_ + natural_merge_overhead_));
+        size_t min_run = std::max<size_t>(1, capacity / min_run_fraction_);
+
+        std::vector<ValueType> temp_data, sort_data;
         temp_data.reserve(capacity);
 
+        // background thread sorting and writing sort_data
+        common::ThreadPool sort_thread(1);
+        std::exception_ptr sort_error;
+        bool failed = false;
+
         while (reader.HasNext()) {
-            if (!mem::memory_exceeded && temp_data.size() < capacity) {
+            if (failed) {
+                // discard items, such that the senders do not block
+                reader.template Next<ValueType>();
+            }
+            else if (temp_data.size() < min_run ||
+                     (!mem::memory_exceeded && temp_data.size() < capacity)) {
                 temp_data.push_back(reader.template Next<ValueType>());
             }
             else {
-                SortAndWriteToFile(temp_data, files_);
+                // wait for the previous run, then sort the full buffer in
+                // the background and continue with the other buffer.
+                sort_thread.LoopUntilEmpty();
+                if (sort_error) {
+                    failed = true;
+                    std::vector<ValueType>().swap(temp_data);
+                    continue;
+                }
+                std::swap(temp_data, sort_data);
+                temp_data.reserve(capacity);
+
+                sort_thread.Enqueue(
+                    [this, &sort_data, &sort_error]() {
+                        try {
+                            SortAndWriteToFile(sort_data, files_);
+                        }
+                        catch (...) {
+                            sort_error = std::current_exception();
+                        }
+                    });
             }
         }
 
+        sort_thread.LoopUntilEmpty();
+        std::vector<ValueType>().swap(sort_data);
+
+        if (sort_error)
+            std::rethrow_exception(sort_error);
+
         if (temp_data.size())
             SortAndWriteToFile(temp_data, files_);
     }
@@ -28,6 +28,7 @@
 #include <array>
 #include <functional>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace thrill {
@@ -38,6 +39,10 @@ namespace api {
  * element-by-element. The ZipNode stores the zip_function UDF. The chainable
  * LOps are stored in the Stack.
  *
+ * If all inputs have equal local sizes on all workers, i.e. are co-partitioned
+ * as in iterative algorithms, which Zip the result of a previous Zip or
+ * ReduceToIndex, then no items are exchanged.
+ *
  * <pre>
  *                ParentStack0 ParentStack1
  *                 +--------+   +--------+
@@ -141,19 +146,22 @@ public:
     void PushData(bool consume) final {
         size_t result_count = 0;
 
-        if (result_size_ != 0) {
+        if (result_size_ != 0 && co_partitioned_) {
+            // read local Files directly, they are already aligned.
+            std::vector<data::File::Reader> readers;
+            readers.reserve(kNumInputs);
+            for (size_t i = 0; i < kNumInputs; ++i)
+                readers.emplace_back(files_[i].GetReader(consume));
+
+            result_count = PushReaders(readers);
+        }
+        else if (result_size_ != 0) {
             // get inbound readers from all Streams
             std::array<data::CatStream::CatReader, kNumInputs> readers;
             for (size_t i = 0; i < kNumInputs; ++i)
                 readers[i] = streams_[i]->GetCatReader(consume);
 
-            ReaderNext reader_next(*this, readers);
-
-            while (reader_next.HasNext()) {
-                auto v = common::VariadicMapEnumerate<kNumInputs>(reader_next);
-                this->PushItem(common::ApplyTuple(zip_function_, v));
-                ++result_count;
-            }
+            result_count = PushReaders(readers);
         }
 
         sLOG << "Zip: result_count" << result_count;
@@ -190,6 +198,10 @@ private:
     //! shortest size of Zipped inputs
     size_t result_size_;
 
+    //! whether all inputs have equal local sizes on all workers, in which case
+    //! no items are exchanged.
+    bool co_partitioned_ = false;
+
     //! \}
 
     //! Register Parent PreOp Hooks, instantiated and called for each Zip parent
@@ -299,10 +311,30 @@ private:
         dia_size_prefixsum_ = context_.net.PrefixSum(
             dia_local_size, ArraySizeT(), common::ComponentSum<ArraySizeT>());
 
-        //! total number of items in DIAs, over all worker. take last worker's
-        //! prefixsum
-        ArraySizeT dia_total_size = context_.net.Broadcast(
-            dia_size_prefixsum_, context_.net.num_workers() - 1);
+        //! the inputs are co-partitioned if their local sizes are equal on
+        //! all workers, as for example after ReduceToIndex() or Zip() with
+        //! equal result sizes, since then the prefix sums are equal.
+        bool local_equal = true;
+        for (size_t i = 1; i < kNumInputs; ++i) {
+            if (dia_size_prefixsum_[i] != dia_size_prefixsum_[0])
+                local_equal = false;
+        }
+
+        //! total number of items in DIAs, over all worker: the maximum of the
+        //! prefixsums, which is combined with the co-partitioning flags.
+        using SizeEqual = std::pair<ArraySizeT, bool>;
+        SizeEqual total_equal = context_.net.AllReduce(
+            SizeEqual(dia_size_prefixsum_, local_equal),
+            [](const SizeEqual& a, const SizeEqual& b) {
+                SizeEqual r;
+                for (size_t i = 0; i < kNumInputs; ++i)
+                    r.first[i] = std::max(a.first[i], b.first[i]);
+                r.second = a.second && b.second;
+                return r;
+            });
+
+        ArraySizeT dia_total_size = total_equal.first;
+        co_partitioned_ = total_equal.second;
 
         size_t max_dia_total_size =
             *std::max_element(dia_total_size.begin(), dia_total_size.end());
@@ -321,6 +353,11 @@ private:
 
         if (result_size_ == 0) return;
 
+        if (co_partitioned_) {
+            LOG << "Zip: inputs are co-partitioned, no items exchanged";
+            return;
+        }
+
         // perform scatters to exchange data, with different types.
         common::VariadicCallEnumerate<kNumInputs>(
             [=](auto index) {
@@ -329,12 +366,29 @@ private:
             });
     }
 
-    //! Access CatReaders for different different parents.
+    //! Zip the items of the readers and push them, returns the number of
+    //! items pushed.
+    template <typename Readers>
+    size_t PushReaders(Readers& readers) {
+        size_t result_count = 0;
+
+        ReaderNext<Readers> reader_next(*this, readers);
+
+        while (reader_next.HasNext()) {
+            auto v = common::VariadicMapEnumerate<kNumInputs>(reader_next);
+            this->PushItem(common::ApplyTuple(zip_function_, v));
+            ++result_count;
+        }
+
+        return result_count;
+    }
+
+    //! Access Readers for different different parents.
+    template <typename Readers>
     class ReaderNext
     {
     public:
-        ReaderNext(ZipNode& zip_node,
-                   std::array<data::CatStream::CatReader, kNumInputs>& readers)
+        ReaderNext(ZipNode& zip_node, Readers& readers)
             : zip_node_(zip_node), readers_(readers) { }
 
         //! helper for PushData() which checks all inputs
@@ -370,7 +424,7 @@ private:
         ZipNode& zip_node_;
 
         //! reference to the reader array in PushData().
-        std::array<data::CatStream::CatReader, kNumInputs>& readers_;
+        Readers& readers_;
     };
 };
 
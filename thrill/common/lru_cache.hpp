@@ -118,6 +118,7 @@ class LruCacheSet
 public:
     using List = typename std::list<Key, Alloc>;
     using ListIterator = typename List::iterator;
+    using ConstReverseIterator = typename List::const_reverse_iterator;
 
     using Map = typename std::unordered_map<
               Key, ListIterator, std::hash<Key>, std::equal_to<Key>,
@@ -175,6 +176,18 @@ public:
         return map_.size();
     }
 
+    //! iterate over keys starting with the least recently used one
+    ConstReverseIterator rbegin() const { return list_.rbegin(); }
+
+    //! end of iteration starting with the least recently used key
+    ConstReverseIterator rend() const { return list_.rend(); }
+
+    //! return the least recently used key without removing it
+    const Key& peek() const {
+        assert(size());
+        return list_.back();
+    }
+
     //! return the least recently used key value pair
     Key pop() {
         assert(size());
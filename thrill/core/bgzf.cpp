@@ -0,0 +1,274 @@
+/*******************************************************************************
+ * thrill/core/bgzf.cpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/common/logger.hpp>
+#include <thrill/common/system_exception.hpp>
+#include <thrill/core/bgzf.hpp>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#if !defined(_MSC_VER)
+#include <unistd.h>
+#endif
+
+#if THRILL_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+namespace thrill {
+namespace core {
+
+constexpr size_t BgzfReader::max_block_size;
+constexpr size_t BgzfReader::header_size;
+
+//! size of windows read from the file
+static constexpr size_t bgzf_window_size = 1024 * 1024;
+
+//! read a little-endian 32-bit integer
+static inline uint32_t GetLE32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+size_t BgzfReader::ParseHeader(const unsigned char* p) {
+    // gzip magic, deflate, FEXTRA flag, XLEN = 6, subfield "BC" of length 2
+    if (p[0] != 31 || p[1] != 139 || p[2] != 8 || (p[3] & 4) == 0 ||
+        p[10] != 6 || p[11] != 0 || p[12] != 'B' || p[13] != 'C' ||
+        p[14] != 2 || p[15] != 0)
+        return 0;
+
+    size_t bsize = (static_cast<size_t>(p[16]) |
+                    (static_cast<size_t>(p[17]) << 8)) + 1;
+
+    // block must contain header, CRC32 and ISIZE
+    if (bsize < header_size + 8) return 0;
+    return bsize;
+}
+
+#if THRILL_HAVE_ZLIB && !defined(_MSC_VER)
+
+struct BgzfReader::ZStream {
+    z_stream zs = z_stream();
+};
+
+void BgzfReader::ZStreamDeleter::operator () (ZStream* zs) const {
+    inflateEnd(&zs->zs);
+    delete zs;
+}
+
+bool BgzfReader::IsBgzfFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    unsigned char header[header_size];
+    ssize_t rb = ::pread(fd, header, header_size, 0);
+    ::close(fd);
+
+    return rb == static_cast<ssize_t>(header_size) && ParseHeader(header) != 0;
+}
+
+void BgzfReader::Open(const std::string& path, uint64_t offset) {
+    Close();
+
+    path_ = path;
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        throw common::ErrnoException("Cannot open file " + path, errno);
+    }
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        throw common::ErrnoException("Cannot stat file " + path, errno);
+    }
+    file_size_ = static_cast<uint64_t>(st.st_size);
+
+    std::unique_ptr<ZStream> zs(new ZStream());
+    if (inflateInit2(&zs->zs, -MAX_WBITS) != Z_OK) {
+        throw common::SystemException("BgzfReader: inflateInit2() failed");
+    }
+    zstream_.reset(zs.release());
+
+    cbuf_.clear();
+    cbuf_offset_ = 0;
+    next_offset_ = offset == 0 ? 0 : FindBlock(offset);
+
+    sLOG << "BgzfReader::Open()" << path << "offset" << offset
+         << "first block" << next_offset_;
+}
+
+void BgzfReader::Close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    zstream_.reset();
+}
+
+const unsigned char* BgzfReader::Fetch(uint64_t offset, size_t size) {
+    if (offset + size > file_size_) return nullptr;
+
+    if (offset >= cbuf_offset_ &&
+        offset + size <= cbuf_offset_ + cbuf_.size()) {
+        return cbuf_.data() + (offset - cbuf_offset_);
+    }
+
+    // read a new window starting at offset
+    size_t window = static_cast<size_t>(
+        std::min<uint64_t>(std::max(size, bgzf_window_size),
+                           file_size_ - offset));
+    cbuf_.resize(window);
+    cbuf_offset_ = offset;
+
+    size_t done = 0;
+    while (done < window) {
+        ssize_t rb = ::pread(fd_, cbuf_.data() + done, window - done,
+                             static_cast<off_t>(offset + done));
+        if (rb <= 0) {
+            cbuf_.clear();
+            throw common::ErrnoException("Error reading " + path_, errno);
+        }
+        done += static_cast<size_t>(rb);
+    }
+
+    return cbuf_.data();
+}
+
+uint64_t BgzfReader::FindBlock(uint64_t offset) {
+    uint64_t pos = offset;
+
+    while (pos + header_size <= file_size_) {
+        size_t window = static_cast<size_t>(
+            std::min<uint64_t>(bgzf_window_size, file_size_ - pos));
+        const unsigned char* p = Fetch(pos, window);
+
+        // search for the gzip magic byte and check the header
+        uint64_t candidate = file_size_;
+        for (size_t i = 0; i + header_size <= window; ++i) {
+            const void* m =
+                std::memchr(p + i, 31, window - header_size + 1 - i);
+            if (m == nullptr) break;
+            i = static_cast<const unsigned char*>(m) - p;
+            if (ParseHeader(p + i) != 0) {
+                candidate = pos + i;
+                break;
+            }
+        }
+
+        if (candidate == file_size_) {
+            // continue after the window, with overlap for a partial header
+            if (window < header_size) break;
+            pos += window - header_size + 1;
+            continue;
+        }
+
+        // verify that the block is followed by another header or the end of
+        // file, since the magic bytes may also occur in compressed data.
+        uint64_t next = candidate + ParseHeader(Fetch(candidate, header_size));
+        if (next == file_size_) return candidate;
+        if (next < file_size_) {
+            const unsigned char* n = Fetch(next, std::min<uint64_t>(
+                                               header_size, file_size_ - next));
+            if (next + header_size <= file_size_ && ParseHeader(n) != 0)
+                return candidate;
+        }
+        pos = candidate + 1;
+    }
+
+    return file_size_;
+}
+
+ssize_t BgzfReader::ReadBlock(void* out) {
+    if (next_offset_ >= file_size_) return -1;
+
+    const unsigned char* h = Fetch(next_offset_, header_size);
+    size_t bsize = h ? ParseHeader(h) : 0;
+    if (bsize == 0) {
+        throw common::SystemException(
+                  "BgzfReader: invalid block header in " + path_ +
+                  " at offset " + std::to_string(next_offset_));
+    }
+
+    const unsigned char* b = Fetch(next_offset_, bsize);
+    if (b == nullptr) {
+        throw common::SystemException(
+                  "BgzfReader: truncated block in " + path_);
+    }
+
+    uint32_t crc = GetLE32(b + bsize - 8);
+    uint32_t isize = GetLE32(b + bsize - 4);
+    if (isize > max_block_size) {
+        throw common::SystemException(
+                  "BgzfReader: invalid block size in " + path_);
+    }
+
+    z_stream* zs = &zstream_->zs;
+    inflateReset(zs);
+    zs->next_in = const_cast<Bytef*>(b + header_size);
+    zs->avail_in = static_cast<uInt>(bsize - header_size - 8);
+    zs->next_out = static_cast<Bytef*>(out);
+    zs->avail_out = static_cast<uInt>(max_block_size);
+
+    int r = inflate(zs, Z_FINISH);
+    if (r != Z_STREAM_END || zs->total_out != isize ||
+        crc32(0, static_cast<const Bytef*>(out), isize) != crc) {
+        throw common::SystemException(
+                  "BgzfReader: corrupt block in " + path_ +
+                  " at offset " + std::to_string(next_offset_));
+    }
+
+    block_offset_ = next_offset_;
+    next_offset_ += bsize;
+    return static_cast<ssize_t>(isize);
+}
+
+#else
+
+struct BgzfReader::ZStream { };
+
+void BgzfReader::ZStreamDeleter::operator () (ZStream* zs) const {
+    delete zs;
+}
+
+bool BgzfReader::IsBgzfFile(const std::string& /* path */) {
+    return false;
+}
+
+void BgzfReader::Open(const std::string& /* path */, uint64_t /* offset */) {
+    throw common::SystemException(
+              "BgzfReader: Thrill was compiled without zlib support.");
+}
+
+void BgzfReader::Close() { }
+
+const unsigned char* BgzfReader::Fetch(uint64_t, size_t) {
+    return nullptr;
+}
+
+uint64_t BgzfReader::FindBlock(uint64_t) {
+    return file_size_;
+}
+
+ssize_t BgzfReader::ReadBlock(void* /* out */) {
+    return -1;
+}
+
+#endif // THRILL_HAVE_ZLIB && !defined(_MSC_VER)
+
+} // namespace core
+} // namespace thrill
+
+/******************************************************************************/
@@ -0,0 +1,135 @@
+/*******************************************************************************
+ * thrill/core/bgzf.hpp
+ *
+ * Reader for BGZF files, which are gzip files consisting of independently
+ * compressed blocks as written by bgzip, and can hence be split and decoded
+ * from any block boundary.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_CORE_BGZF_HEADER
+#define THRILL_CORE_BGZF_HEADER
+
+#include <thrill/common/porting.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace thrill {
+namespace core {
+
+/*!
+ * Reads and decompresses a BGZF file block-wise in-process using zlib. Each
+ * BGZF block is a complete gzip member with an extra field containing the
+ * compressed block size, and decompresses to at most max_block_size bytes.
+ *
+ * Open() can start at an arbitrary byte offset: the reader then scans forward
+ * to the first block header at or after the offset, which allows splitting a
+ * single file among workers. All methods throw common::SystemException on
+ * errors, and if Thrill was compiled without zlib.
+ */
+class BgzfReader
+{
+    static constexpr bool debug = false;
+
+public:
+    //! maximum decompressed (and compressed) size of a BGZF block
+    static constexpr size_t max_block_size = 65536;
+
+    //! size of a BGZF block header
+    static constexpr size_t header_size = 18;
+
+    //! Returns true if path is a gzip file in BGZF format which can be decoded
+    //! by this reader, i.e. if Thrill has zlib support.
+    static bool IsBgzfFile(const std::string& path);
+
+    BgzfReader() = default;
+
+    //! non-copyable: delete copy-constructor
+    BgzfReader(const BgzfReader&) = delete;
+    //! non-copyable: delete assignment operator
+    BgzfReader& operator = (const BgzfReader&) = delete;
+
+    ~BgzfReader() {
+        Close();
+    }
+
+    //! Open file at path and seek to the first block starting at or after
+    //! offset.
+    void Open(const std::string& path, uint64_t offset = 0);
+
+    //! Close the file.
+    void Close();
+
+    /*!
+     * Decompress the next block into out, which must have room for
+     * max_block_size bytes. Returns the decompressed size, which may be zero
+     * for empty blocks, or -1 at the end of file.
+     */
+    ssize_t ReadBlock(void* out);
+
+    //! Returns the file offset of the block last returned by ReadBlock()
+    uint64_t block_offset() const { return block_offset_; }
+
+    //! Returns the file offset of the block to be read next by ReadBlock()
+    uint64_t next_offset() const { return next_offset_; }
+
+    //! Returns the compressed file size
+    uint64_t file_size() const { return file_size_; }
+
+private:
+    //! file descriptor
+    int fd_ = -1;
+
+    //! path of the file for error messages
+    std::string path_;
+
+    //! size of the file
+    uint64_t file_size_ = 0;
+
+    //! buffer of compressed data read from the file
+    std::vector<unsigned char> cbuf_;
+
+    //! file offset of cbuf_[0]
+    uint64_t cbuf_offset_ = 0;
+
+    //! file offset of the next block
+    uint64_t next_offset_ = 0;
+
+    //! file offset of the block last returned
+    uint64_t block_offset_ = 0;
+
+    //! zlib stream state, opaque to keep zlib.h out of the header
+    struct ZStream;
+    //! deleter calling inflateEnd() before freeing the ZStream
+    struct ZStreamDeleter {
+        void operator () (ZStream* zs) const;
+    };
+    std::unique_ptr<ZStream, ZStreamDeleter> zstream_;
+
+    //! Ensure that [offset, offset + size) of the file is in cbuf_, and
+    //! return a pointer to it, or nullptr if the range exceeds the file.
+    const unsigned char * Fetch(uint64_t offset, size_t size);
+
+    //! Return the total block size if p points to a valid BGZF block header,
+    //! otherwise zero.
+    static size_t ParseHeader(const unsigned char* p);
+
+    //! Find the first valid block header at or after offset.
+    uint64_t FindBlock(uint64_t offset);
+};
+
+} // namespace core
+} // namespace thrill
+
+#endif // !THRILL_CORE_BGZF_HEADER
+
+/******************************************************************************/
@@ -0,0 +1,358 @@
+/*******************************************************************************
+ * thrill/core/duplicate_detection.hpp
+ *
+ * Distributed detection of keys which occur on more than one worker, by
+ * exchanging compact fingerprints of the keys' hashes.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_CORE_DUPLICATE_DETECTION_HEADER
+#define THRILL_CORE_DUPLICATE_DETECTION_HEADER
+
+#include <thrill/api/context.hpp>
+#include <thrill/common/logger.hpp>
+#include <thrill/common/math.hpp>
+#include <thrill/core/multiway_merge.hpp>
+#include <thrill/data/file.hpp>
+#include <thrill/net/buffer_builder.hpp>
+#include <thrill/net/buffer_reader.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace thrill {
+namespace core {
+
+/*!
+ * Detects which hash values occur more than once globally. Each hash value is
+ * assigned to an owner worker by its upper 32 bits, and truncated to a
+ * fingerprint of fingerprint_bits() lower bits. Every worker sends its sorted
+ * fingerprints to their owners, encoded as varint deltas, which are much
+ * smaller than the keys themselves. The owners find the fingerprints received
+ * more than once, and reply them to the workers which sent them.
+ *
+ * Equal keys always have equal fingerprints, hence keys for which
+ * IsDuplicate() returns false occur only once. Fingerprint collisions only
+ * cause false positives.
+ *
+ * The fingerprints are sent in sorted runs bounded by the memory limit, and the
+ * owners spill sorted runs of received fingerprints to Files and merge them.
+ */
+class DuplicateDetection
+{
+    static constexpr bool debug = false;
+
+    //! number of fingerprint bits in addition to log2 of the number of hashes,
+    //! which determines the false positive rate of about 2^-extra_bits_.
+    static constexpr size_t extra_bits_ = 12;
+
+    //! maximum number of fingerprints encoded into a single item
+    static constexpr size_t max_batch_size_ = 65536;
+
+    //! minimum number of fingerprints in a run, regardless of the memory limit
+    static constexpr size_t min_run_size_ = 4096;
+
+    //! received fingerprint and the rank of its sender
+    using FingerprintSender = std::pair<uint64_t, size_t>;
+
+public:
+    //! Returns the worker owning the fingerprint of hash.
+    static size_t Owner(uint64_t hash, size_t num_workers) {
+        return static_cast<size_t>(((hash >> 32) * num_workers) >> 32);
+    }
+
+    //! Returns the fingerprint of hash.
+    uint64_t Fingerprint(uint64_t hash) const {
+        return fingerprint_bits_ >= 64
+               ? hash : hash & ((uint64_t(1) << fingerprint_bits_) - 1);
+    }
+
+    //! Returns the number of bits of the fingerprints
+    size_t fingerprint_bits() const { return fingerprint_bits_; }
+
+    //! Returns the number of runs of received fingerprints spilled to Files
+    //! by the last FindDuplicates().
+    size_t num_spilled_runs() const { return num_spilled_runs_; }
+
+    /*!
+     * Exchange the fingerprints of the hash values of the items in file and
+     * find those which occur more than once. This is a collective operation.
+     *
+     * \param ctx Context of the worker
+     *
+     * \param dia_id id of the DIANode, for the Streams and Files
+     *
+     * \param file local items, which are read but not consumed
+     *
+     * \param hash_function calculates the hash value of an item
+     *
+     * \param mem_limit number of bytes for the buffers of fingerprints
+     */
+    template <typename ValueType, typename HashFunction>
+    void FindDuplicates(Context& ctx, size_t dia_id, data::File& file,
+                        const HashFunction& hash_function, size_t mem_limit) {
+        size_t num_workers = ctx.num_workers();
+
+        size_t total_hashes = ctx.net.AllReduce(file.num_items());
+        fingerprint_bits_ =
+            common::IntegerLog2Ceil(total_hashes + 1) + extra_bits_;
+
+        data::CatStreamPtr fp_stream = ctx.GetNewCatStream(dia_id);
+        SendFingerprints<ValueType>(
+            ctx, *fp_stream, file, hash_function,
+            RunSize(mem_limit / 2, sizeof(uint64_t)));
+
+        data::CatStreamPtr dup_stream = ctx.GetNewCatStream(dia_id);
+        ReplyDuplicates(
+            ctx, dia_id, *fp_stream, *dup_stream,
+            RunSize(mem_limit / 2, sizeof(FingerprintSender)));
+        fp_stream->Close();
+
+        duplicates_.clear();
+        duplicates_.resize(num_workers);
+        {
+            auto reader = dup_stream->GetCatReader(/* consume */ true);
+            while (reader.HasNext()) {
+                GetFingerprints(
+                    reader.Next<std::string>(),
+                    [this](size_t owner, uint64_t fp) {
+                        duplicates_[owner].push_back(fp);
+                    });
+            }
+        }
+        dup_stream->Close();
+
+        LOG << "DuplicateDetection: " << file.num_items() << " local hashes,"
+            << " fingerprint_bits " << fingerprint_bits_
+            << " spilled_runs " << num_spilled_runs_;
+    }
+
+    //! Returns true if the hash value may occur more than once. Only valid
+    //! after FindDuplicates().
+    bool IsDuplicate(uint64_t hash) const {
+        const std::vector<uint64_t>& dups =
+            duplicates_[Owner(hash, duplicates_.size())];
+        return std::binary_search(dups.begin(), dups.end(), Fingerprint(hash));
+    }
+
+private:
+    //! number of bits of the fingerprints
+    size_t fingerprint_bits_ = 64;
+
+    //! number of runs of received fingerprints spilled to Files
+    size_t num_spilled_runs_ = 0;
+
+    //! sorted duplicate fingerprints for each owner
+    std::vector<std::vector<uint64_t> > duplicates_;
+
+    //! Number of items of item_size fitting into mem_limit bytes, but at least
+    //! min_run_size_.
+    static size_t RunSize(size_t mem_limit, size_t item_size) {
+        size_t size = mem_limit / item_size;
+        return size < min_run_size_ ? min_run_size_ : size;
+    }
+
+    /*!
+     * Encodes increasing fingerprints as strings of varint deltas, each
+     * prefixed with the rank of the sender, and writes them into a Writer.
+     */
+    template <typename Writer>
+    class FingerprintWriter
+    {
+    public:
+        FingerprintWriter(Writer& writer, size_t rank)
+            : writer_(writer), rank_(rank) { }
+
+        //! Append a fingerprint, which must not be less than the previous one
+        //! since the last Flush().
+        void Put(uint64_t fp) {
+            if (size_ == 0) bb_.PutVarint(rank_);
+            assert(fp >= prev_);
+            bb_.PutVarint(fp - prev_);
+            prev_ = fp;
+            if (++size_ == max_batch_size_) Flush();
+        }
+
+        //! Write out the current string of fingerprints.
+        void Flush() {
+            if (size_ == 0) return;
+            writer_.Put(bb_.ToString());
+            bb_.Clear();
+            prev_ = 0, size_ = 0;
+        }
+
+    private:
+        Writer& writer_;
+        size_t rank_;
+        net::BufferBuilder bb_;
+        uint64_t prev_ = 0;
+        size_t size_ = 0;
+    };
+
+    //! Read the items of file, and send their fingerprints to the owners in
+    //! runs of at most run_size sorted fingerprints.
+    template <typename ValueType, typename HashFunction>
+    void SendFingerprints(Context& ctx, data::CatStream& fp_stream,
+                          data::File& file, const HashFunction& hash_function,
+                          size_t run_size) {
+        size_t num_workers = ctx.num_workers();
+
+        using Writer = data::Stream::Writer;
+        std::vector<Writer> writers = fp_stream.GetWriters();
+        std::vector<FingerprintWriter<Writer> > fp_writers;
+        fp_writers.reserve(num_workers);
+        for (size_t w = 0; w < num_workers; ++w)
+            fp_writers.emplace_back(writers[w], ctx.my_rank());
+
+        // sort fingerprints by owner, directly from the items
+        std::vector<std::vector<uint64_t> > buckets(num_workers);
+        size_t run_items = 0;
+
+        auto flush_run =
+            [&]() {
+                for (size_t w = 0; w < num_workers; ++w) {
+                    std::sort(buckets[w].begin(), buckets[w].end());
+                    for (const uint64_t& fp : buckets[w])
+                        fp_writers[w].Put(fp);
+                    fp_writers[w].Flush();
+                    buckets[w].clear();
+                }
+                run_items = 0;
+            };
+
+        auto reader = file.GetKeepReader();
+        while (reader.HasNext()) {
+            uint64_t h = hash_function(reader.template Next<ValueType>());
+            buckets[Owner(h, num_workers)].push_back(Fingerprint(h));
+            if (++run_items == run_size) flush_run();
+        }
+        flush_run();
+
+        for (Writer& w : writers)
+            w.Close();
+    }
+
+    //! Receive fingerprints as pairs (fingerprint, sender), sort them in runs
+    //! of at most run_size pairs, and reply the fingerprints received more
+    //! than once to their senders.
+    void ReplyDuplicates(Context& ctx, size_t dia_id,
+                         data::CatStream& fp_stream,
+                         data::CatStream& dup_stream, size_t run_size) {
+        size_t num_workers = ctx.num_workers();
+        num_spilled_runs_ = 0;
+
+        std::vector<data::File> runs;
+        std::vector<FingerprintSender> recv;
+        {
+            auto reader = fp_stream.GetCatReader(/* consume */ true);
+            while (reader.HasNext()) {
+                GetFingerprints(
+                    reader.Next<std::string>(),
+                    [&](size_t sender, uint64_t fp) {
+                        recv.emplace_back(fp, sender);
+                        if (recv.size() == run_size)
+                            SpillRun(ctx, dia_id, recv, runs);
+                    });
+            }
+        }
+
+        using Writer = data::Stream::Writer;
+        std::vector<Writer> writers = dup_stream.GetWriters();
+        std::vector<FingerprintWriter<Writer> > fp_writers;
+        fp_writers.reserve(num_workers);
+        for (size_t w = 0; w < num_workers; ++w)
+            fp_writers.emplace_back(writers[w], ctx.my_rank());
+
+        // scan the sorted pairs: the first pair of a fingerprint is held back
+        // until a second one is seen, then each sender gets the fingerprint
+        // once.
+        FingerprintSender first;
+        bool have_first = false, replied = false;
+        size_t last_sender = 0;
+
+        auto process =
+            [&](const FingerprintSender& p) {
+                if (!have_first || p.first != first.first) {
+                    first = p, have_first = true, replied = false;
+                    return;
+                }
+                if (!replied) {
+                    fp_writers[first.second].Put(first.first);
+                    last_sender = first.second, replied = true;
+                }
+                if (p.second != last_sender) {
+                    fp_writers[p.second].Put(p.first);
+                    last_sender = p.second;
+                }
+            };
+
+        if (runs.empty()) {
+            std::sort(recv.begin(), recv.end());
+            for (const FingerprintSender& p : recv)
+                process(p);
+        }
+        else {
+            // spill the last run and merge all runs
+            if (!recv.empty()) SpillRun(ctx, dia_id, recv, runs);
+            num_spilled_runs_ = runs.size();
+
+            std::vector<data::File::ConsumeReader> seq;
+            seq.reserve(runs.size());
+            for (data::File& f : runs)
+                seq.emplace_back(f.GetConsumeReader());
+
+            auto puller = make_multiway_merge_tree<FingerprintSender>(
+                seq.begin(), seq.end(), std::less<FingerprintSender>());
+            while (puller.HasNext())
+                process(puller.Next());
+        }
+        std::vector<FingerprintSender>().swap(recv);
+
+        for (size_t w = 0; w < num_workers; ++w) {
+            fp_writers[w].Flush();
+            writers[w].Close();
+        }
+    }
+
+    //! Sort the received pairs and write them as a run into a new File.
+    static void SpillRun(Context& ctx, size_t dia_id,
+                         std::vector<FingerprintSender>& recv,
+                         std::vector<data::File>& runs) {
+        std::sort(recv.begin(), recv.end());
+        runs.emplace_back(ctx.GetFile(dia_id));
+        auto writer = runs.back().GetWriter();
+        for (const FingerprintSender& p : recv)
+            writer.Put(p);
+        writer.Close();
+        recv.clear();
+    }
+
+    //! Decode a string of fingerprints and call func(sender, fingerprint).
+    template <typename Function>
+    static void GetFingerprints(const std::string& str, const Function& func) {
+        net::BufferReader br(str);
+        size_t rank = br.GetVarint();
+        uint64_t fp = 0;
+        while (!br.empty()) {
+            fp += br.GetVarint();
+            func(rank, fp);
+        }
+    }
+};
+
+} // namespace core
+} // namespace thrill
+
+#endif // !THRILL_CORE_DUPLICATE_DETECTION_HEADER
+
+/******************************************************************************/
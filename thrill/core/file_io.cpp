@@ -38,7 +38,13 @@
 
 #endif
 
+#if THRILL_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
 #include <algorithm>
+#include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -160,7 +166,98 @@ SysFileList GlobFileSizePrefixSum(const std::vector<std::string>& files) {
 
 /******************************************************************************/
 
+#if THRILL_HAVE_ZLIB
+
+struct SysFile::GzipState {
+    //! zlib stream state
+    z_stream            zs = z_stream();
+    //! buffer of compressed data read from the file
+    std::vector<Bytef>  in;
+    //! true if inside a gzip member, false if between members
+    bool                in_member = false;
+    //! number of gzip members decompressed completely
+    size_t              members = 0;
+    //! end of the compressed file reached
+    bool                eof = false;
+};
+
+void SysFile::GzipStateDeleter::operator () (GzipState* state) const {
+    inflateEnd(&state->zs);
+    delete state;
+}
+
+ssize_t SysFile::ReadGzip(void* data, size_t count) {
+    z_stream& zs = gzip_->zs;
+
+    count = std::min<size_t>(count, std::numeric_limits<uInt>::max());
+    zs.next_out = static_cast<Bytef*>(data);
+    zs.avail_out = static_cast<uInt>(count);
+
+    // inflate until at least some output is produced or the file ends.
+    while (zs.avail_out == count) {
+        if (zs.avail_in == 0) {
+            if (gzip_->eof) break;
+            ssize_t rb = ::read(fd_, gzip_->in.data(), gzip_->in.size());
+            if (rb < 0) return rb;
+            if (rb == 0) {
+                gzip_->eof = true;
+                if (gzip_->in_member) {
+                    throw common::SystemException(
+                              "SysFile: unexpected end of gzip stream");
+                }
+                break;
+            }
+            zs.next_in = gzip_->in.data();
+            zs.avail_in = static_cast<uInt>(rb);
+        }
+
+        // after a complete member, ignore trailing data which does not start
+        // with the gzip magic bytes, e.g. zero padding, like gzip does.
+        if (gzip_->members != 0 && !gzip_->in_member &&
+            (zs.next_in[0] != 0x1F ||
+             (zs.avail_in >= 2 && zs.next_in[1] != 0x8B))) {
+            sLOG << "SysFile::ReadGzip(): ignoring trailing data";
+            zs.avail_in = 0;
+            gzip_->eof = true;
+            break;
+        }
+
+        int r = inflate(&zs, Z_NO_FLUSH);
+        if (r == Z_STREAM_END) {
+            // gzip files may consist of multiple concatenated members
+            inflateReset(&zs);
+            gzip_->in_member = false;
+            ++gzip_->members;
+        }
+        else if (r == Z_OK || r == Z_BUF_ERROR) {
+            gzip_->in_member = true;
+        }
+        else {
+            throw common::SystemException(
+                      "SysFile: error decompressing gzip stream: " +
+                      std::string(zs.msg ? zs.msg : std::to_string(r)));
+        }
+    }
+
+    return static_cast<ssize_t>(count - zs.avail_out);
+}
+
+#else
+
+struct SysFile::GzipState { };
+
+void SysFile::GzipStateDeleter::operator () (GzipState* state) const {
+    delete state;
+}
+
+ssize_t SysFile::ReadGzip(void* /* data */, size_t /* count */) {
+    return -1;
+}
+
+#endif // THRILL_HAVE_ZLIB
+
 void SysFile::close() {
+    gzip_.reset();
     if (fd_ >= 0) {
         sLOG << "SysFile::close(): fd" << fd_;
         if (::close(fd_) != 0)
@@ -220,7 +317,28 @@ SysFile SysFile::OpenForRead(const std::string& path) {
     const char* decompressor;
 
     if (common::EndsWith(path, ".gz")) {
+#if THRILL_HAVE_ZLIB
+        // decompress gzip files in-process, which avoids the pipe and the
+        // extra copy.
+        common::PortSetCloseOnExec(fd);
+
+        std::unique_ptr<GzipState> state(new GzipState());
+        // windowBits + 32: automatically detect gzip and zlib headers
+        if (inflateInit2(&state->zs, 15 + 32) != Z_OK) {
+            ::close(fd);
+            throw common::SystemException(
+                      "SysFile: inflateInit2() failed for " + path);
+        }
+        state->in.resize(1024 * 1024);
+
+        sLOG << "SysFile::OpenForRead(): gzip filefd" << fd;
+
+        SysFile file(fd);
+        file.gzip_.reset(state.release());
+        return file;
+#else
         decompressor = "gzip";
+#endif
     }
     else if (common::EndsWith(path, ".bz2")) {
         decompressor = "bzip2";
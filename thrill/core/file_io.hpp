@@ -27,6 +27,7 @@
 
 #endif
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -109,7 +110,8 @@ public:
     /*!
      * Open file for reading and return file descriptor. Handles compressed
      * files by calling a decompressor in a pipe, like "cat $f | gzip -dc |" in
-     * bash.
+     * bash. If Thrill was compiled with zlib, gzip files are instead
+     * decompressed in-process by read().
      *
      * \param path Path to open
      */
@@ -129,13 +131,13 @@ public:
     SysFile& operator = (const SysFile&) = delete;
     //! move-constructor
     SysFile(SysFile&& f) noexcept
-        : fd_(f.fd_), pid_(f.pid_) {
+        : fd_(f.fd_), pid_(f.pid_), gzip_(std::move(f.gzip_)) {
         f.fd_ = -1, f.pid_ = 0;
     }
     //! move-assignment
     SysFile& operator = (SysFile&& f) {
         close();
-        fd_ = f.fd_, pid_ = f.pid_;
+        fd_ = f.fd_, pid_ = f.pid_, gzip_ = std::move(f.gzip_);
         f.fd_ = -1, f.pid_ = 0;
         return *this;
     }
@@ -153,6 +155,7 @@ public:
     //! POSIX read function.
     ssize_t read(void* data, size_t count) {
         assert(fd_ >= 0);
+        if (gzip_) return ReadGzip(data, count);
 #if defined(_MSC_VER)
         return ::_read(fd_, data, static_cast<unsigned>(count));
 #else
@@ -187,6 +190,17 @@ private:
 
     //! pid of child process to wait for
     pid_t pid_ = 0;
+
+    //! zlib inflate state, if the gzip file is decompressed in-process
+    struct GzipState;
+    //! deleter calling inflateEnd() before freeing the GzipState
+    struct GzipStateDeleter {
+        void operator () (GzipState* state) const;
+    };
+    std::unique_ptr<GzipState, GzipStateDeleter> gzip_;
+
+    //! read and inflate from a gzip file, handles concatenated members.
+    ssize_t ReadGzip(void* data, size_t count);
 };
 
 /*!
@@ -0,0 +1,134 @@
+/*******************************************************************************
+ * thrill/core/hyperloglog.hpp
+ *
+ * HyperLogLog registers for approximate distinct counting.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_CORE_HYPERLOGLOG_HEADER
+#define THRILL_CORE_HYPERLOGLOG_HEADER
+
+#include <thrill/common/math.hpp>
+#include <thrill/core/reduce_functional.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace thrill {
+namespace core {
+
+/*!
+ * HyperLogLog sketch (Flajolet et al.) with 2^precision one-byte registers.
+ * Items are inserted by their 64-bit hash: the lowest precision bits select a
+ * register, which stores the maximum position of the first one bit of the
+ * remaining hash bits. Sketches with equal precision can be merged by taking
+ * the register-wise maximum, which makes them suitable for AllReduce.
+ */
+class HyperLogLogRegisters
+{
+public:
+    //! minimum and maximum supported precision
+    static constexpr size_t min_precision = 4;
+    static constexpr size_t max_precision = 18;
+
+    explicit HyperLogLogRegisters(size_t precision = 14)
+        : precision_(precision),
+          registers_(size_t(1) << precision, 0) {
+        assert(precision >= min_precision && precision <= max_precision);
+    }
+
+    //! Insert a 64-bit hash value into the registers.
+    void InsertHash(uint64_t hash) {
+        size_t index = hash & (registers_.size() - 1);
+        uint64_t rest = hash >> precision_;
+        // position of first one bit in the remaining bits, or one beyond.
+        uint8_t rank = static_cast<uint8_t>(
+            rest ? common::ffs(rest) : 64 - precision_ + 1);
+        registers_[index] = std::max(registers_[index], rank);
+    }
+
+    //! Insert an item, which is hashed using hash_function and then mixed.
+    template <typename Type, typename HashFunction = std::hash<Type> >
+    void Insert(const Type& item,
+                const HashFunction& hash_function = HashFunction()) {
+        InsertHash(Hash128to64(/* salt */ 0, hash_function(item)));
+    }
+
+    //! Merge another sketch into this by calculating the register-wise maximum.
+    HyperLogLogRegisters& Merge(const HyperLogLogRegisters& other) {
+        assert(precision_ == other.precision_);
+        for (size_t i = 0; i < registers_.size(); ++i)
+            registers_[i] = std::max(registers_[i], other.registers_[i]);
+        return *this;
+    }
+
+    //! Calculate the cardinality estimate including the small range
+    //! correction. No large range correction is needed for 64-bit hashes.
+    double Estimate() const {
+        const double m = static_cast<double>(registers_.size());
+
+        double sum = 0.0;
+        size_t zeros = 0;
+        for (const uint8_t& r : registers_) {
+            sum += std::ldexp(1.0, -static_cast<int>(r));
+            if (r == 0) ++zeros;
+        }
+
+        double estimate = alpha() * m * m / sum;
+
+        if (estimate <= 2.5 * m && zeros != 0) {
+            // small range correction: use linear counting
+            estimate = m * std::log(m / static_cast<double>(zeros));
+        }
+        return estimate;
+    }
+
+    //! \name Accessors
+    //! \{
+
+    //! Returns precision_
+    size_t precision() const { return precision_; }
+
+    //! Returns the vector of registers
+    const std::vector<uint8_t>& registers() const { return registers_; }
+
+    //! Returns the vector of registers (mutable)
+    std::vector<uint8_t>& registers() { return registers_; }
+
+    //! \}
+
+private:
+    //! number of hash bits used for selecting a register
+    size_t precision_;
+
+    //! HyperLogLog registers, one byte each.
+    std::vector<uint8_t> registers_;
+
+    //! bias correction constant depending on the number of registers
+    double alpha() const {
+        switch (registers_.size()) {
+        case 16: return 0.673;
+        case 32: return 0.697;
+        case 64: return 0.709;
+        default:
+            return 0.7213 / (1.0 + 1.079 / static_cast<double>(registers_.size()));
+        }
+    }
+};
+
+} // namespace core
+} // namespace thrill
+
+#endif // !THRILL_CORE_HYPERLOGLOG_HEADER
+
+/******************************************************************************/
@@ -0,0 +1,106 @@
+/*******************************************************************************
+ * thrill/core/multikey_quicksort.hpp
+ *
+ * Multikey quicksort for std::string items, which does not compare the common
+ * prefixes of strings again and again like std::sort.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_CORE_MULTIKEY_QUICKSORT_HEADER
+#define THRILL_CORE_MULTIKEY_QUICKSORT_HEADER
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace thrill {
+namespace core {
+
+//! Character of s at depth, shifted by one such that the end of the string is
+//! zero and sorts before all other characters.
+static inline int MultikeyCharAt(const std::string& s, size_t depth) {
+    return depth < s.size() ? static_cast<unsigned char>(s[depth]) + 1 : 0;
+}
+
+/*!
+ * Sort strings lexicographically using multikey quicksort (Bentley and
+ * Sedgewick), which partitions the strings by their character at depth into
+ * less, equal, and greater parts. The equal part is then sorted by the next
+ * character. All strings must have a common prefix of length depth.
+ */
+static inline
+void MultikeyQuicksort(std::string* a, size_t n, size_t depth = 0) {
+    while (n > 1) {
+        if (n < 32) {
+            // insertion sort, comparing only after the common prefix
+            for (size_t i = 1; i < n; ++i) {
+                for (size_t j = i; j > 0 &&
+                     a[j - 1].compare(depth, std::string::npos,
+                                      a[j], depth, std::string::npos) > 0;
+                     --j) {
+                    std::swap(a[j - 1], a[j]);
+                }
+            }
+            return;
+        }
+
+        // median of three pivot character
+        int c0 = MultikeyCharAt(a[0], depth);
+        int c1 = MultikeyCharAt(a[n / 2], depth);
+        int c2 = MultikeyCharAt(a[n - 1], depth);
+        int pivot = std::max(std::min(c0, c1), std::min(std::max(c0, c1), c2));
+
+        // three-way partition into [0,lt) < pivot, [lt,gt) = pivot, and
+        // [gt,n) > pivot.
+        size_t lt = 0, i = 0, gt = n;
+        while (i < gt) {
+            int c = MultikeyCharAt(a[i], depth);
+            if (c < pivot)
+                std::swap(a[lt++], a[i++]);
+            else if (c > pivot)
+                std::swap(a[i], a[--gt]);
+            else
+                ++i;
+        }
+
+        MultikeyQuicksort(a, lt, depth);
+        MultikeyQuicksort(a + gt, n - gt, depth);
+
+        // strings in the equal part ended: they are all equal.
+        if (pivot == 0) return;
+
+        // iterate on the equal part with the next character
+        a += lt, n = gt - lt, ++depth;
+    }
+}
+
+/*!
+ * Sort items with the comparator. Uses MultikeyQuicksort() if the items are
+ * std::string compared with std::less, otherwise std::sort().
+ */
+template <typename Iterator, typename Comparator>
+void SortItems(Iterator begin, Iterator end, const Comparator& comp) {
+    std::sort(begin, end, comp);
+}
+
+//! Sort std::strings lexicographically with MultikeyQuicksort()
+static inline
+void SortItems(std::string* begin, std::string* end,
+               const std::less<std::string>& /* comp */) {
+    MultikeyQuicksort(begin, end - begin);
+}
+
+} // namespace core
+} // namespace thrill
+
+#endif // !THRILL_CORE_MULTIKEY_QUICKSORT_HEADER
+
+/******************************************************************************/
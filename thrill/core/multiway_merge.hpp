@@ -12,9 +12,15 @@
 #ifndef THRILL_CORE_MULTIWAY_MERGE_HEADER
 #define THRILL_CORE_MULTIWAY_MERGE_HEADER
 
+#include <thrill/common/porting.hpp>
 #include <thrill/core/losertree.hpp>
+#include <thrill/data/file.hpp>
 
 #include <algorithm>
+#include <functional>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -91,10 +97,174 @@ private:
     std::vector<std::pair<bool, ValueType> > current_;
 };
 
+/*!
+ * Multiway merge tree for std::string items compared lexicographically, which
+ * uses an LCP-aware loser tree. Each loser in the tree stores the length of its
+ * longest common prefix (LCP) with the winner of its match. After the winner
+ * is output, the next string of its input gets the LCP with the winner, which
+ * is its predecessor. Matches along the path to the root then compare only
+ * LCPs, and characters only after the common prefix.
+ */
+template <typename ReaderIterator>
+class MultiwayMergeTreeLcp
+{
+public:
+    using Reader = typename std::iterator_traits<ReaderIterator>::value_type;
+
+    MultiwayMergeTreeLcp(ReaderIterator readers_begin,
+                         ReaderIterator readers_end)
+        : readers_(readers_begin),
+          num_inputs_(static_cast<unsigned>(readers_end - readers_begin)) {
+
+        num_leaves_ = 1;
+        while (num_leaves_ < num_inputs_) num_leaves_ *= 2;
+
+        current_.resize(num_leaves_);
+        exists_.resize(num_leaves_, false);
+        tree_.resize(num_leaves_);
+
+        for (unsigned t = 0; t < num_inputs_; ++t) {
+            if (THRILL_LIKELY(readers_[t].HasNext())) {
+                current_[t] = readers_[t].template Next<std::string>();
+                exists_[t] = true;
+                ++remaining_inputs_;
+            }
+        }
+
+        winner_ = Build(1);
+    }
+
+    bool HasNext() const {
+        return (remaining_inputs_ != 0);
+    }
+
+    std::string Next() {
+        // take next smallest element out
+        unsigned top = winner_.index;
+        std::string res = std::move(current_[top]);
+
+        Contender c { top, 0 };
+        if (THRILL_LIKELY(readers_[top].HasNext())) {
+            current_[top] = readers_[top].template Next<std::string>();
+            c.lcp = Lcp(res, current_[top], 0);
+        }
+        else {
+            exists_[top] = false;
+            assert(remaining_inputs_ > 0);
+            --remaining_inputs_;
+        }
+
+        // replay matches on the path to the root, all LCPs are relative to
+        // res.
+        for (unsigned node = (num_leaves_ + top) / 2; node >= 1; node /= 2)
+            c = Play(node, c, tree_[node]);
+        winner_ = c;
+
+        return res;
+    }
+
+private:
+    //! input index and LCP with the winner of the match or the last output
+    struct Contender {
+        unsigned index;
+        size_t   lcp;
+    };
+
+    ReaderIterator readers_;
+    unsigned num_inputs_;
+    unsigned num_leaves_;
+    size_t remaining_inputs_ = 0;
+
+    //! current string of each input
+    std::vector<std::string> current_;
+    //! whether the input has a current string
+    std::vector<bool> exists_;
+    //! losers of the matches in the inner nodes [1,num_leaves_)
+    std::vector<Contender> tree_;
+    //! overall winner
+    Contender winner_;
+
+    //! length of the common prefix of a and b, which is at least h.
+    static size_t Lcp(const std::string& a, const std::string& b, size_t h) {
+        size_t n = std::min(a.size(), b.size());
+        while (h < n && a[h] == b[h]) ++h;
+        return h;
+    }
+
+    //! build the subtree at node, returns its winner.
+    Contender Build(unsigned node) {
+        if (node >= num_leaves_)
+            return Contender { node - num_leaves_, 0 };
+        Contender a = Build(2 * node);
+        Contender b = Build(2 * node + 1);
+        return Play(node, a, b);
+    }
+
+    //! play a match between a and b, whose LCPs are relative to the same
+    //! string which is not greater than both. Stores the loser in node and
+    //! returns the winner.
+    Contender Play(unsigned node, Contender a, Contender b) {
+        bool a_wins;
+        if (!exists_[b.index])
+            a_wins = true;
+        else if (!exists_[a.index])
+            a_wins = false;
+        else if (a.lcp != b.lcp)
+            a_wins = a.lcp > b.lcp;
+        else {
+            const std::string& sa = current_[a.index];
+            const std::string& sb = current_[b.index];
+            size_t h = Lcp(sa, sb, a.lcp);
+            if (h == sa.size())
+                a_wins = true;
+            else if (h == sb.size())
+                a_wins = false;
+            else
+                a_wins = static_cast<unsigned char>(sa[h]) <
+                         static_cast<unsigned char>(sb[h]);
+            // loser's LCP with the winner
+            if (a_wins) b.lcp = h;
+            else a.lcp = h;
+        }
+
+        if (a_wins) {
+            tree_[node] = b;
+            return a;
+        }
+        else {
+            tree_[node] = a;
+            return b;
+        }
+    }
+};
+
+//! whether make_multiway_merge_tree() uses the LCP-aware merge tree
+template <typename ValueType, typename Comparator>
+using UseMultiwayMergeTreeLcp = std::integral_constant<
+          bool, std::is_same<ValueType, std::string>::value&&
+          std::is_same<Comparator, std::less<std::string> >::value>;
+
+template <typename ValueType, typename ReaderIterator, typename Comparator>
+auto make_multiway_merge_tree_dispatch(
+    ReaderIterator seqs_begin, ReaderIterator seqs_end,
+    const Comparator& comp, std::false_type /* lcp */) {
+    return MultiwayMergeTree<
+        ValueType, ReaderIterator,
+        Comparator>(seqs_begin, seqs_end, comp);
+}
+
+template <typename ValueType, typename ReaderIterator, typename Comparator>
+auto make_multiway_merge_tree_dispatch(
+    ReaderIterator seqs_begin, ReaderIterator seqs_end,
+    const Comparator& /* comp */, std::true_type /* lcp */) {
+    return MultiwayMergeTreeLcp<ReaderIterator>(seqs_begin, seqs_end);
+}
+
 /*!
  * Sequential multi-way merging switch for a file writer as output
  *
- * The decision if based on the branching factor and runtime settings.
+ * The decision if based on the branching factor and runtime settings. Strings
+ * compared with std::less are merged with the LCP-aware MultiwayMergeTreeLcp.
  *
  * \param seqs_begin Begin iterator of iterator pair input sequence.
  * \param seqs_end End iterator of iterator pair input sequence.
@@ -109,9 +279,259 @@ auto make_multiway_merge_tree(
     const Comparator &comp) {
 
     assert(seqs_end - seqs_begin >= 1);
-    return MultiwayMergeTree<
-        ValueType, ReaderIterator,
-        Comparator>(seqs_begin, seqs_end, comp);
+    return make_multiway_merge_tree_dispatch<ValueType>(
+        seqs_begin, seqs_end, comp,
+        UseMultiwayMergeTreeLcp<ValueType, Comparator>());
+}
+
+/*!
+ * Reader adapter which delivers only the given number of items from a File
+ * Reader, used to merge a range of items of each File.
+ */
+template <typename Reader>
+class MultiwayMergeRangeReader
+{
+public:
+    MultiwayMergeRangeReader(Reader&& reader, size_t size)
+        : reader_(std::move(reader)), remaining_(size) { }
+
+    bool HasNext() const { return remaining_ != 0; }
+
+    template <typename ItemType>
+    ItemType Next() {
+        assert(remaining_ > 0);
+        --remaining_;
+        return reader_.template Next<ItemType>();
+    }
+
+private:
+    Reader reader_;
+    size_t remaining_;
+};
+
+/*!
+ * Split the key space of sorted Files into num_parts disjoint ranges, which
+ * can then be merged independently. Splitters are picked from evenly spaced
+ * samples of each File weighted by File size, and their positions in each File
+ * are located by binary search.
+ *
+ * \return for each File the num_parts + 1 item indexes of the range
+ * boundaries, part j consists of items [bounds[f][j], bounds[f][j+1]) of all
+ * Files f.
+ */
+template <typename ValueType, typename FileIterator, typename Comparator>
+std::vector<std::vector<size_t> > multiway_merge_split_files(
+    FileIterator files_begin, FileIterator files_end, size_t num_parts,
+    const Comparator& comp) {
+
+    assert(num_parts >= 1);
+    size_t num_files = files_end - files_begin;
+
+    // draw num_parts - 1 evenly spaced samples from each File
+    size_t total_items = 0;
+    std::vector<std::pair<ValueType, size_t> > samples;
+    for (FileIterator f = files_begin; f != files_end; ++f) {
+        size_t n = f->num_items();
+        total_items += n;
+        if (n == 0) continue;
+        for (size_t j = 1; j < num_parts; ++j) {
+            samples.emplace_back(
+                f->template GetItemAt<ValueType>(j * n / num_parts),
+                n / num_parts);
+        }
+    }
+
+    std::sort(samples.begin(), samples.end(),
+              [&comp](const std::pair<ValueType, size_t>& a,
+                      const std::pair<ValueType, size_t>& b) {
+                  return comp(a.first, b.first);
+              });
+
+    // pick splitters at the weighted quantiles of the samples
+    std::vector<ValueType> splitters;
+    size_t weight = 0;
+    for (const std::pair<ValueType, size_t>& s : samples) {
+        weight += s.second;
+        while (splitters.size() + 1 < num_parts &&
+               weight >= (splitters.size() + 1) * total_items / num_parts)
+            splitters.push_back(s.first);
+    }
+
+    // locate the splitters in each File: part j contains items less than
+    // splitter j, which are not less than splitter j - 1.
+    std::vector<std::vector<size_t> > bounds(num_files);
+    for (size_t i = 0; i < num_files; ++i) {
+        const data::File& file = files_begin[i];
+        std::vector<size_t>& b = bounds[i];
+        b.reserve(num_parts + 1);
+        b.push_back(0);
+
+        for (const ValueType& splitter : splitters) {
+            size_t left = b.back(), right = file.num_items();
+            while (left < right) {
+                size_t mid = (left + right) / 2;
+                if (comp(file.template GetItemAt<ValueType>(mid), splitter))
+                    left = mid + 1;
+                else
+                    right = mid;
+            }
+            b.push_back(left);
+        }
+        // missing splitters: remaining parts are empty
+        while (b.size() < num_parts + 1)
+            b.push_back(file.num_items());
+        b.back() = file.num_items();
+    }
+
+    return bounds;
+}
+
+/*!
+ * Blocks of a sorted File containing the items of one part of a parallel merge:
+ * the first skip items belong to the preceding part, followed by the size items
+ * of this part.
+ */
+struct MultiwayMergeFilePart {
+    data::File file;
+    size_t     skip;
+    size_t     size;
+};
+
+/*!
+ * Distribute the Blocks of sorted Files among the num_parts parts determined
+ * by multiway_merge_split_files(), and clear the Files. Each part then consumes
+ * its own Blocks, which are thus freed while merging instead of keeping all
+ * input Files until all parts are done. Only Blocks spanning a part boundary
+ * are referenced by both parts.
+ *
+ * eturn for each part the ranges of all Files with items in the part.
+ */
+template <typename FileIterator>
+std::vector<std::vector<MultiwayMergeFilePart> > multiway_merge_take_parts(
+    FileIterator files_begin, FileIterator files_end,
+    const std::vector<std::vector<size_t> >& bounds, size_t num_parts) {
+
+    std::vector<std::vector<MultiwayMergeFilePart> > parts(num_parts);
+
+    for (size_t i = 0; files_begin + i != files_end; ++i) {
+        data::File& file = files_begin[i];
+
+        // items_before[b] is the number of items starting in Blocks before b
+        std::vector<size_t> items_before(file.num_blocks() + 1, 0);
+        for (size_t b = 0; b < file.num_blocks(); ++b)
+            items_before[b + 1] = items_before[b] + file.ItemsStartIn(b);
+
+        // index of the Block in which item k starts
+        auto block_of =
+            [&items_before](size_t k) {
+                return static_cast<size_t>(
+                    std::upper_bound(items_before.begin(),
+                                     items_before.end(), k) -
+                    items_before.begin()) - 1;
+            };
+
+        for (size_t p = 0; p < num_parts; ++p) {
+            size_t begin = bounds[i][p], end = bounds[i][p + 1];
+            if (begin == end) continue;
+
+            // the last item may continue up to the Block where the next part
+            // starts.
+            size_t first = block_of(begin);
+            size_t last = end == file.num_items()
+                          ? file.num_blocks() - 1 : block_of(end);
+
+            data::File part(*file.block_pool(), file.local_worker_id(),
+                            /* dia_id */ 0);
+            part.SetEvictionHint(file.eviction_hint());
+            for (size_t b = first; b <= last; ++b) {
+                data::Block block = file.block(b);
+                // skip the tail of an item continued from the previous Block
+                if (b == first) block.set_begin(block.first_item_absolute());
+                part.AppendBlock(std::move(block));
+            }
+
+            parts[p].emplace_back(MultiwayMergeFilePart {
+                                      std::move(part),
+                                      begin - items_before[first], end - begin
+                                  });
+        }
+
+        file.Clear();
+    }
+
+    return parts;
+}
+
+/*!
+ * Merge the Files of one part, as returned by multiway_merge_take_parts(), and
+ * deliver the items to emit in order. The part's Files are consumed.
+ */
+template <typename ValueType, typename Comparator, typename Emitter>
+void multiway_merge_file_part(
+    std::vector<MultiwayMergeFilePart>& files,
+    size_t prefetch, const Comparator& comp, const Emitter& emit) {
+
+    using Reader = MultiwayMergeRangeReader<data::File::ConsumeReader>;
+
+    std::vector<Reader> seq;
+    seq.reserve(files.size());
+
+    for (MultiwayMergeFilePart& f : files) {
+        data::File::ConsumeReader reader = f.file.GetConsumeReader(prefetch);
+        // skip the items of the preceding part in the first Block
+        for (size_t i = 0; i < f.skip; ++i)
+            reader.template Next<ValueType>();
+        seq.emplace_back(std::move(reader), f.size);
+    }
+    if (seq.empty()) return;
+
+    auto puller = make_multiway_merge_tree<ValueType>(
+        seq.begin(), seq.end(), comp);
+
+    while (puller.HasNext())
+        emit(puller.Next());
+}
+
+/*!
+ * Merge sorted Files into output using one thread per File in parts. The key
+ * space is split into parts.size() ranges, each thread merges one range into
+ * its part File, and the parts are then concatenated into output. The input
+ * Files are consumed.
+ */
+template <typename ValueType, typename FileIterator, typename Comparator>
+void parallel_multiway_merge_files(
+    FileIterator files_begin, FileIterator files_end,
+    std::vector<data::File>& parts, size_t prefetch, const Comparator& comp,
+    data::File& output) {
+
+    std::vector<std::vector<size_t> > bounds =
+        multiway_merge_split_files<ValueType>(
+            files_begin, files_end, parts.size(), comp);
+
+    std::vector<std::vector<MultiwayMergeFilePart> > inputs =
+        multiway_merge_take_parts(files_begin, files_end, bounds, parts.size());
+
+    auto merge_part =
+        [&](size_t p) {
+            data::File::Writer writer = parts[p].GetWriter();
+            multiway_merge_file_part<ValueType>(
+                inputs[p], prefetch, comp,
+                [&writer](const ValueType& v) { writer.Put(v); });
+            writer.Close();
+        };
+
+    std::vector<std::thread> threads;
+    for (size_t p = 1; p < parts.size(); ++p)
+        threads.emplace_back(common::CreateThread(merge_part, p));
+    merge_part(0);
+    for (std::thread& t : threads)
+        t.join();
+
+    for (data::File& part : parts) {
+        for (const data::Block& b : part.blocks())
+            output.AppendBlock(b);
+        part.Clear();
+    }
 }
 
 } // namespace core
@@ -348,6 +348,30 @@ public:
             SpillPartition(h.partition_id);
     }
 
+    /*!
+     * Returns a pointer to the value of key in the table, or nullptr if the key
+     * is not in the table. The pointer is valid until the next Insert().
+     */
+    Value * Find(const Key& key) {
+        typename IndexFunction::Result h = index_function_(
+            key, num_partitions_, num_buckets_per_partition_, num_buckets_);
+
+        size_t global_index = h.partition_id * num_buckets_per_partition_
+                              + h.local_index(num_buckets_per_partition_);
+
+        for (BucketBlock* current = buckets_[global_index];
+             current != nullptr; current = current->next)
+        {
+            for (KeyValuePair* bi = current->items;
+                 bi != current->items + current->size; ++bi)
+            {
+                if (equal_to_function_(key, bi->first))
+                    return &bi->second;
+            }
+        }
+        return nullptr;
+    }
+
     //! Deallocate memory
     void Dispose() {
         // destroy all block chains
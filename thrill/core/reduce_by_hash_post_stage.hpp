@@ -22,6 +22,7 @@
 #include <thrill/core/reduce_functional.hpp>
 #include <thrill/core/reduce_old_probing_hash_table.hpp>
 #include <thrill/core/reduce_probing_hash_table.hpp>
+#include <thrill/core/reduce_string_probing_hash_table.hpp>
 #include <thrill/data/file.hpp>
 
 #include <algorithm>
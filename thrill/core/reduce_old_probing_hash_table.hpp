@@ -260,6 +260,41 @@ public:
             SpillPartition(h.partition_id);
     }
 
+    /*!
+     * Returns a pointer to the value of key in the table, or nullptr if the key
+     * is not in the table. The pointer is valid until the next Insert().
+     */
+    Value * Find(const Key& key) {
+        typename IndexFunction::Result h = index_function_(
+            key, num_partitions_, num_buckets_per_partition_, num_buckets_);
+
+        if (key == Key()) {
+            return sentinel_partition_ == invalid_partition_
+                   ? nullptr : &items_[num_buckets_].second;
+        }
+
+        KeyValueIterator pbegin =
+            items_.begin() + h.partition_id * num_buckets_per_partition_;
+        KeyValueIterator pend = pbegin + num_buckets_per_partition_;
+
+        KeyValueIterator begin_iter =
+            pbegin + h.local_index(num_buckets_per_partition_);
+        KeyValueIterator iter = begin_iter;
+
+        while (!equal_to_function_(iter->first, Key()))
+        {
+            if (equal_to_function_(iter->first, key))
+                return &iter->second;
+
+            // wrap around if beyond the current partition
+            if (++iter == pend)
+                iter = pbegin;
+            if (iter == begin_iter)
+                break;
+        }
+        return nullptr;
+    }
+
     //! Deallocate memory
     void Dispose() {
         std::vector<KeyValuePair>().swap(items_);
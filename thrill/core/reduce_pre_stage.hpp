@@ -21,6 +21,7 @@
 #include <thrill/core/reduce_functional.hpp>
 #include <thrill/core/reduce_old_probing_hash_table.hpp>
 #include <thrill/core/reduce_probing_hash_table.hpp>
+#include <thrill/core/reduce_string_probing_hash_table.hpp>
 #include <thrill/data/block_writer.hpp>
 
 #include <algorithm>
@@ -46,6 +47,10 @@ public:
     static void Put(const KeyValuePair& p, data::DynBlockWriter& writer) {
         writer.Put(p.second);
     }
+    template <typename KeyValueRef>
+    static void PutRef(const KeyValueRef& ref, data::DynBlockWriter& writer) {
+        writer.Put(ref.value());
+    }
 };
 
 template <typename KeyValuePair>
@@ -55,6 +60,10 @@ public:
     static void Put(const KeyValuePair& p, data::DynBlockWriter& writer) {
         writer.Put(p);
     }
+    template <typename KeyValueRef>
+    static void PutRef(const KeyValueRef& ref, data::DynBlockWriter& writer) {
+        ref.Put(writer);
+    }
 };
 
 //! Emitter implementation to plug into a reduce hash table for
@@ -79,6 +88,16 @@ public:
             p, writer_[partition_id]);
     }
 
+    //! output an element referenced by a StringKeyValueRef into a partition,
+    //! without constructing the key/value pair.
+    template <typename KeyValueRef>
+    void EmitRef(const size_t& partition_id, const KeyValueRef& ref) {
+        assert(partition_id < writer_.size());
+        stats_[partition_id]++;
+        ReducePreStageEmitterSwitch<KeyValuePair, VolatileKey>::PutRef(
+            ref, writer_[partition_id]);
+    }
+
     void Flush(size_t partition_id) {
         assert(partition_id < writer_.size());
         writer_[partition_id].Flush();
@@ -101,6 +120,15 @@ public:
     std::vector<size_t> stats_;
 };
 
+//! Emit a StringKeyValueRef from a ReduceStringProbingHashTable directly into
+//! the pre-stage's writers.
+template <typename Value, bool VolatileKey>
+void EmitKeyValueRef(
+    ReducePreStageEmitter<std::pair<std::string, Value>, VolatileKey>& emitter,
+    const size_t& partition_id, const StringKeyValueRef<Value>& ref) {
+    emitter.EmitRef(partition_id, ref);
+}
+
 template <typename ValueType, typename Key, typename Value,
           typename KeyExtractor, typename ReduceFunction,
           const bool VolatileKey,
@@ -163,6 +191,12 @@ public:
         return table_.Insert(kv);
     }
 
+    //! Returns a pointer to the value of key in the table, or nullptr if the
+    //! key is not in the table. The pointer is valid until the next Insert().
+    Value * Find(const Key& key) {
+        return table_.Find(key);
+    }
+
     //! Flush all partitions
     void FlushAll() {
         for (size_t id = 0; id < table_.num_partitions(); ++id) {
@@ -269,6 +269,40 @@ public:
             SpillPartition(h.partition_id);
     }
 
+    /*!
+     * Returns a pointer to the value of key in the table, or nullptr if the key
+     * is not in the table. The pointer is valid until the next Insert().
+     */
+    Value * Find(const Key& key) {
+        typename IndexFunction::Result h = index_function_(
+            key, num_partitions_, num_buckets_per_partition_, num_buckets_);
+
+        if (key == Key()) {
+            return sentinel_partition_ == invalid_partition_
+                   ? nullptr : &items_[num_buckets_].second;
+        }
+
+        KeyValuePair* pbegin = items_ + h.partition_id * num_buckets_per_partition_;
+        KeyValuePair* pend = pbegin + partition_size_[h.partition_id];
+
+        KeyValuePair* begin_iter =
+            pbegin + h.local_index(partition_size_[h.partition_id]);
+        KeyValuePair* iter = begin_iter;
+
+        while (!equal_to_function_(iter->first, Key()))
+        {
+            if (equal_to_function_(iter->first, key))
+                return &iter->second;
+
+            // wrap around if beyond the current partition
+            if (++iter == pend)
+                iter = pbegin;
+            if (iter == begin_iter)
+                break;
+        }
+        return nullptr;
+    }
+
     //! Deallocate items and memory
     void Dispose() {
         if (!items_) return;
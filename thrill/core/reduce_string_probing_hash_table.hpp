@@ -0,0 +1,662 @@
+/*******************************************************************************
+ * thrill/core/reduce_string_probing_hash_table.hpp
+ *
+ * Linear probing reduce hash table for std::string keys, which stores the key
+ * bytes in per-partition arenas instead of individually allocated strings.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_CORE_REDUCE_STRING_PROBING_HASH_TABLE_HEADER
+#define THRILL_CORE_REDUCE_STRING_PROBING_HASH_TABLE_HEADER
+
+#include <thrill/core/reduce_functional.hpp>
+#include <thrill/core/reduce_table.hpp>
+#include <thrill/data/serialization.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace thrill {
+namespace core {
+
+/*!
+ * Reference to a key/value pair stored in a ReduceStringProbingHashTable, with
+ * the key bytes residing in the table's arena. It is serialized exactly like a
+ * std::pair<std::string, Value>, hence it can be written into Files and
+ * Streams without constructing a std::string, and read back as the pair.
+ */
+template <typename Value>
+class StringKeyValueRef
+{
+public:
+    using KeyValuePair = std::pair<std::string, Value>;
+
+    StringKeyValueRef(const char* key, size_t size, const Value& value)
+        : key_(key), size_(size), value_(value) { }
+
+    const char * key() const { return key_; }
+    size_t size() const { return size_; }
+    const Value& value() const { return value_; }
+
+    //! Construct the referenced key/value pair.
+    KeyValuePair ToPair() const {
+        return KeyValuePair(std::string(key_, size_), value_);
+    }
+
+    //! Write the key/value pair into a BlockWriter. With self-verification,
+    //! the items are prefixed with their type hash, hence the actual pair must
+    //! be written.
+    template <typename Writer>
+    void Put(Writer& writer) const {
+        if (Writer::self_verify)
+            writer.Put(ToPair());
+        else
+            writer.Put(*this);
+    }
+
+private:
+    //! pointer to the key bytes
+    const char* key_;
+    //! length of the key
+    size_t size_;
+    //! reference to the value in the table
+    const Value& value_;
+};
+
+//! Emit a key/value pair referenced by a StringKeyValueRef. This is overloaded
+//! for emitters which can serialize the reference directly.
+template <typename Emitter, typename Value>
+void EmitKeyValueRef(Emitter& emitter, const size_t& partition_id,
+                     const StringKeyValueRef<Value>& ref) {
+    emitter.Emit(partition_id, ref.ToPair());
+}
+
+/*!
+ * A linear probing reduce hash table specialized for std::string keys, which
+ * is selected by ReduceTableSelect for ReduceTableImpl::PROBING if the keys
+ * are std::string hashed by ReduceByHash and compared with std::equal_to, and
+ * the values are stored without their key (VolatileKey, as in ReducePair).
+ * Otherwise each value would contain another copy of the key, with its own
+ * heap allocation which the table's memory limit does not account for.
+ *
+ * Instead of std::pair<std::string, Value>, the slots contain a pointer to the
+ * key's bytes, the key's length, a fingerprint of the key's hash, and the
+ * value. The key bytes are copied into a bump allocated arena of the key's
+ * partition, which avoids a heap allocation for each std::string key and
+ * keeps the keys of a partition close together. Probing compares the hash
+ * fingerprints and lengths before comparing the key bytes.
+ *
+ * When a partition is spilled or flushed, the items are serialized directly
+ * from the slots and the arena via StringKeyValueRef, afterwards the arena is
+ * reset. Half of the memory limit is used for the slots, the other half for
+ * the arenas. A partition is also spilled when its arena exceeds its share.
+ */
+template <typename ValueType, typename Value,
+          typename KeyExtractor, typename ReduceFunction, typename Emitter,
+          const bool VolatileKey,
+          typename ReduceConfig_,
+          typename IndexFunction,
+          typename EqualToFunction = std::equal_to<std::string> >
+class ReduceStringProbingHashTable
+    : public ReduceTable<ValueType, std::string, Value,
+                         KeyExtractor, ReduceFunction, Emitter,
+                         VolatileKey, ReduceConfig_,
+                         IndexFunction, EqualToFunction>
+{
+    using Super = ReduceTable<ValueType, std::string, Value,
+                              KeyExtractor, ReduceFunction, Emitter,
+                              VolatileKey, ReduceConfig_, IndexFunction,
+                              EqualToFunction>;
+    using Super::debug;
+    static constexpr bool debug_items = false;
+
+public:
+    using Key = std::string;
+    using KeyValuePair = std::pair<Key, Value>;
+    using KeyValueRef = StringKeyValueRef<Value>;
+    using ReduceConfig = ReduceConfig_;
+
+    ReduceStringProbingHashTable(
+        Context& ctx, size_t dia_id,
+        const KeyExtractor& key_extractor,
+        const ReduceFunction& reduce_function,
+        Emitter& emitter,
+        size_t num_partitions,
+        const ReduceConfig& config = ReduceConfig(),
+        bool immediate_flush = false,
+        const IndexFunction& index_function = IndexFunction(),
+        const EqualToFunction& equal_to_function = EqualToFunction())
+        : Super(ctx, dia_id,
+                key_extractor, reduce_function, emitter,
+                num_partitions, config, immediate_flush,
+                index_function, equal_to_function)
+    { assert(num_partitions > 0); }
+
+    //! Construct the slots of the hash table and the arenas.
+    void Initialize(size_t limit_memory_bytes) {
+        assert(!slots_);
+
+        limit_memory_bytes_ = limit_memory_bytes;
+
+        // calculate num_buckets_per_partition_ from half of the memory limit
+        // and the number of partitions required, initialize partition_size_
+        // array.
+
+        num_buckets_per_partition_ = std::max<size_t>(
+            1,
+            (size_t)(static_cast<double>(limit_memory_bytes_) / 2.0
+                     / static_cast<double>(sizeof(Slot))
+                     / static_cast<double>(num_partitions_)));
+
+        num_buckets_ = num_buckets_per_partition_ * num_partitions_;
+
+        partition_size_.resize(
+            num_partitions_,
+            std::min(size_t(config_.initial_items_per_partition_),
+                     num_buckets_per_partition_));
+
+        // the other half of the memory limit is for the arenas, which allocate
+        // blocks of a fraction of their limit.
+
+        limit_arena_bytes_per_partition_ =
+            limit_memory_bytes_ / 2 / num_partitions_;
+        if (limit_arena_bytes_per_partition_ < min_arena_block_size_)
+            limit_arena_bytes_per_partition_ = min_arena_block_size_;
+
+        arena_block_size_ = limit_arena_bytes_per_partition_ / 4;
+        if (arena_block_size_ < min_arena_block_size_)
+            arena_block_size_ = min_arena_block_size_;
+        if (arena_block_size_ > max_arena_block_size_)
+            arena_block_size_ = max_arena_block_size_;
+
+        arenas_.resize(num_partitions_);
+
+        // calculate limit on the number of items in a partition before these
+        // are spilled to disk or flushed to network.
+
+        double limit_fill_rate = config_.limit_partition_fill_rate();
+
+        assert(limit_fill_rate >= 0.0 && limit_fill_rate <= 1.0
+               && "limit_partition_fill_rate must be between 0.0 and 1.0. "
+               "with a fill rate of 0.0, items are immediately flushed.");
+
+        limit_items_per_partition_ = (size_t)(
+            static_cast<double>(num_buckets_per_partition_) * limit_fill_rate);
+
+        // actually allocate the slots and initialize the valid ranges
+
+        slots_ = static_cast<Slot*>(operator new (num_buckets_ * sizeof(Slot)));
+
+        for (size_t id = 0; id < num_partitions_; ++id) {
+            Slot* iter = slots_ + id * num_buckets_per_partition_;
+            Slot* pend = iter + partition_size_[id];
+
+            for ( ; iter != pend; ++iter)
+                new (iter)Slot();
+        }
+    }
+
+    ~ReduceStringProbingHashTable() {
+        if (slots_) Dispose();
+    }
+
+    /*!
+     * Inserts a value. Calls the key_extractor_, makes a key-value-pair and
+     * inserts the pair via the Insert() function.
+     */
+    void Insert(const Value& p) {
+        Insert(std::make_pair(key_extractor_(p), p));
+    }
+
+    /*!
+     * Inserts a value into the table, potentially reducing it in case both the
+     * key of the value already in the table and the key of the value to be
+     * inserted are the same. Otherwise the key is copied into the partition's
+     * arena.
+     *
+     * \param kv Value to be inserted into the table.
+     */
+    void Insert(const KeyValuePair& kv) {
+
+        while (mem::memory_exceeded && num_items_ != 0)
+            SpillAnyPartition();
+
+        typename IndexFunction::Result h = index_function_(
+            kv.first, num_partitions_,
+            num_buckets_per_partition_, num_buckets_);
+
+        assert(h.partition_id < num_partitions_);
+
+        const uint32_t fingerprint = Fingerprint(h.remaining_hash);
+        const size_t size = kv.first.size();
+        assert(size <= std::numeric_limits<uint32_t>::max());
+
+        // calculate local index depending on the current subtable's size
+        size_t local_index = h.local_index(partition_size_[h.partition_id]);
+
+        Slot* pbegin = slots_ + h.partition_id * num_buckets_per_partition_;
+        Slot* pend = pbegin + partition_size_[h.partition_id];
+
+        Slot* begin_iter = pbegin + local_index;
+        Slot* iter = begin_iter;
+
+        while (iter->key != nullptr)
+        {
+            if (iter->fingerprint == fingerprint && iter->size == size &&
+                std::memcmp(iter->key, kv.first.data(), size) == 0)
+            {
+                LOGC(debug_items)
+                    << "match of key: " << kv.first << " ... reducing...";
+
+                iter->value = reduce_function_(iter->value, kv.second);
+
+                return;
+            }
+
+            ++iter;
+
+            // wrap around if beyond the current partition
+            if (iter == pend)
+                iter = pbegin;
+
+            // flush partition and retry, if all slots are reserved
+            if (iter == begin_iter) {
+                SpillPartition(h.partition_id);
+                return Insert(kv);
+            }
+        }
+
+        // insert new pair, copy the key into the arena
+        Arena& arena = arenas_[h.partition_id];
+        char* key = arena.Allocate(size, arena_block_size_);
+        std::copy(kv.first.data(), kv.first.data() + size, key);
+
+        iter->key = key;
+        iter->size = static_cast<uint32_t>(size);
+        iter->fingerprint = fingerprint;
+        iter->value = kv.second;
+
+        // increase counter for partition
+        ++items_per_partition_[h.partition_id];
+        ++num_items_;
+
+        while (items_per_partition_[h.partition_id] > limit_items_per_partition_
+               || arena.size() > limit_arena_bytes_per_partition_)
+            SpillPartition(h.partition_id);
+    }
+
+    /*!
+     * Returns a pointer to the value of key in the table, or nullptr if the key
+     * is not in the table. The pointer is valid until the next Insert().
+     */
+    Value * Find(const Key& key) {
+        typename IndexFunction::Result h = index_function_(
+            key, num_partitions_, num_buckets_per_partition_, num_buckets_);
+
+        const uint32_t fingerprint = Fingerprint(h.remaining_hash);
+        const size_t size = key.size();
+
+        Slot* pbegin = slots_ + h.partition_id * num_buckets_per_partition_;
+        Slot* pend = pbegin + partition_size_[h.partition_id];
+
+        Slot* begin_iter =
+            pbegin + h.local_index(partition_size_[h.partition_id]);
+        Slot* iter = begin_iter;
+
+        while (iter->key != nullptr)
+        {
+            if (iter->fingerprint == fingerprint && iter->size == size &&
+                std::memcmp(iter->key, key.data(), size) == 0)
+                return &iter->value;
+
+            // wrap around if beyond the current partition
+            if (++iter == pend)
+                iter = pbegin;
+            if (iter == begin_iter)
+                break;
+        }
+        return nullptr;
+    }
+
+    //! Deallocate items and memory
+    void Dispose() {
+        if (!slots_) return;
+
+        // dispose the items by destructor
+
+        for (size_t id = 0; id < num_partitions_; ++id) {
+            Slot* iter = slots_ + id * num_buckets_per_partition_;
+            Slot* pend = iter + partition_size_[id];
+
+            for ( ; iter != pend; ++iter)
+                iter->~Slot();
+        }
+
+        operator delete (slots_);
+        slots_ = nullptr;
+
+        std::vector<Arena>().swap(arenas_);
+
+        Super::Dispose();
+    }
+
+    //! Grow a partition after a spill or flush (if possible)
+    void GrowPartition(size_t partition_id) {
+
+        if (partition_size_[partition_id] == num_buckets_per_partition_)
+            return;
+
+        size_t new_size = std::min(
+            num_buckets_per_partition_, 2 * partition_size_[partition_id]);
+
+        sLOG << "Growing partition" << partition_id
+             << "from" << partition_size_[partition_id] << "to" << new_size;
+
+        // initialize new slots
+
+        Slot* pbegin = slots_ + partition_id * num_buckets_per_partition_;
+        Slot* iter = pbegin + partition_size_[partition_id];
+        Slot* pend = pbegin + new_size;
+
+        for ( ; iter != pend; ++iter)
+            new (iter)Slot();
+
+        partition_size_[partition_id] = new_size;
+    }
+
+    //! \name Spilling Mechanisms to External Memory Files
+    //! \{
+
+    //! Spill all items of a partition into an external memory File.
+    void SpillPartition(size_t partition_id) {
+
+        if (immediate_flush_)
+            return FlushPartition(partition_id, true);
+
+        LOG << "Spilling " << items_per_partition_[partition_id]
+            << " items of partition with id: " << partition_id;
+
+        if (items_per_partition_[partition_id] == 0)
+            return;
+
+        data::File::Writer writer = partition_files_[partition_id].GetWriter();
+
+        Slot* iter = slots_ + partition_id * num_buckets_per_partition_;
+        Slot* pend = iter + partition_size_[partition_id];
+
+        for ( ; iter != pend; ++iter) {
+            if (iter->key != nullptr) {
+                iter->ref().Put(writer);
+                *iter = Slot();
+            }
+        }
+
+        arenas_[partition_id].Clear();
+
+        // reset partition specific counter
+        num_items_ -= items_per_partition_[partition_id];
+        items_per_partition_[partition_id] = 0;
+        assert(num_items_ == this->num_items_calc());
+
+        LOG << "Spilled items of partition with id: " << partition_id;
+
+        GrowPartition(partition_id);
+    }
+
+    //! Spill all items of an arbitrary partition into an external memory File.
+    void SpillAnyPartition() {
+        // maybe make a policy later -tb
+        return SpillLargestPartition();
+    }
+
+    //! Spill all items of the largest partition into an external memory File.
+    void SpillLargestPartition() {
+        // get partition with max size
+        size_t size_max = 0, index = 0;
+
+        for (size_t i = 0; i < num_partitions_; ++i)
+        {
+            if (items_per_partition_[i] > size_max)
+            {
+                size_max = items_per_partition_[i];
+                index = i;
+            }
+        }
+
+        if (size_max == 0) {
+            return;
+        }
+
+        return SpillPartition(index);
+    }
+
+    //! \}
+
+    //! \name Flushing Mechanisms to Next Stage
+    //! \{
+
+    //! Flush a partition by calling emit(partition_id, ref) with a
+    //! StringKeyValueRef to each item.
+    template <typename EmitRef>
+    void FlushPartitionEmitRef(
+        size_t partition_id, bool consume, EmitRef emit_ref) {
+
+        LOG << "Flushing " << items_per_partition_[partition_id]
+            << " items of partition: " << partition_id;
+
+        Slot* iter = slots_ + partition_id * num_buckets_per_partition_;
+        Slot* pend = iter + partition_size_[partition_id];
+
+        for ( ; iter != pend; ++iter)
+        {
+            if (iter->key != nullptr) {
+                emit_ref(partition_id, iter->ref());
+
+                if (consume)
+                    *iter = Slot();
+            }
+        }
+
+        if (consume) {
+            arenas_[partition_id].Clear();
+
+            // reset partition specific counter
+            num_items_ -= items_per_partition_[partition_id];
+            items_per_partition_[partition_id] = 0;
+            assert(num_items_ == this->num_items_calc());
+        }
+
+        LOG << "Done flushed items of partition: " << partition_id;
+
+        GrowPartition(partition_id);
+    }
+
+    template <typename Emit>
+    void FlushPartitionEmit(size_t partition_id, bool consume, Emit emit) {
+        FlushPartitionEmitRef(
+            partition_id, consume,
+            [&emit](const size_t& partition_id, const KeyValueRef& ref) {
+                emit(partition_id, ref.ToPair());
+            });
+    }
+
+    void FlushPartition(size_t partition_id, bool consume) {
+        FlushPartitionEmitRef(
+            partition_id, consume,
+            [this](const size_t& partition_id, const KeyValueRef& ref) {
+                EmitKeyValueRef(this->emitter_, partition_id, ref);
+            });
+    }
+
+    void FlushAll() {
+        for (size_t i = 0; i < num_partitions_; ++i) {
+            FlushPartition(i, true);
+        }
+    }
+
+    //! \}
+
+private:
+    using Super::config_;
+    using Super::immediate_flush_;
+    using Super::index_function_;
+    using Super::items_per_partition_;
+    using Super::key_extractor_;
+    using Super::limit_items_per_partition_;
+    using Super::limit_memory_bytes_;
+    using Super::num_buckets_;
+    using Super::num_buckets_per_partition_;
+    using Super::num_items_;
+    using Super::num_partitions_;
+    using Super::partition_files_;
+    using Super::reduce_function_;
+
+    //! A slot of the hash table, empty if key is nullptr.
+    struct Slot {
+        //! pointer to the key bytes in the partition's arena
+        const char* key = nullptr;
+        //! length of the key
+        uint32_t size = 0;
+        //! bits of the key's hash, compared before the key bytes
+        uint32_t fingerprint = 0;
+        //! the value
+        Value value = Value();
+
+        KeyValueRef ref() const { return KeyValueRef(key, size, value); }
+    };
+
+    //! A bump allocator for the key bytes of a partition. The memory is only
+    //! released by Clear().
+    class Arena
+    {
+    public:
+        //! Allocate size bytes, which may be zero. Never returns nullptr.
+        char * Allocate(size_t size, size_t block_size) {
+            if (current_ == nullptr ||
+                size > static_cast<size_t>(end_ - current_)) {
+                // the first block is kept on Clear(), hence it is never
+                // enlarged for a single large key.
+                if (blocks_.empty() && size > block_size)
+                    AddBlock(block_size);
+                AddBlock(std::max(size, block_size));
+            }
+            char* p = current_;
+            current_ += size;
+            size_ += size;
+            return p;
+        }
+
+        //! Release all blocks except the first one.
+        void Clear() {
+            if (blocks_.empty()) return;
+            blocks_.erase(blocks_.begin() + 1, blocks_.end());
+            current_ = blocks_[0].data.get();
+            end_ = current_ + blocks_[0].size;
+            size_ = 0;
+        }
+
+        //! Returns the number of bytes allocated since the last Clear().
+        size_t size() const { return size_; }
+
+    private:
+        struct Block {
+            std::unique_ptr<char[]> data;
+            size_t                  size;
+        };
+
+        //! blocks of memory
+        std::vector<Block> blocks_;
+
+        //! current position and end of the last block
+        char* current_ = nullptr;
+        char* end_ = nullptr;
+
+        //! bytes allocated since the last Clear()
+        size_t size_ = 0;
+
+        void AddBlock(size_t size) {
+            blocks_.emplace_back(
+                Block { std::unique_ptr<char[]>(new char[size]), size });
+            current_ = blocks_.back().data.get();
+            end_ = current_ + size;
+        }
+    };
+
+    //! minimum and maximum size of the blocks of the arenas
+    static constexpr size_t min_arena_block_size_ = 256;
+    static constexpr size_t max_arena_block_size_ = 64 * 1024;
+
+    //! Storing the actual hash table.
+    Slot* slots_ = nullptr;
+
+    //! Current sizes of the partitions because the valid allocated areas grow
+    std::vector<size_t> partition_size_;
+
+    //! arenas for the key bytes, one per partition
+    std::vector<Arena> arenas_;
+
+    //! limit on the bytes in an arena before the partition is spilled
+    size_t limit_arena_bytes_per_partition_;
+
+    //! size of the blocks allocated by the arenas
+    size_t arena_block_size_;
+
+    //! Fingerprint of the key's hash stored in the slots, mixing the upper bits
+    //! into those which determine the local index.
+    static uint32_t Fingerprint(uint64_t hash) {
+        return static_cast<uint32_t>(hash ^ (hash >> 32));
+    }
+};
+
+template <typename ValueType, typename Value,
+          typename KeyExtractor, typename ReduceFunction,
+          typename Emitter, typename ReduceConfig, typename HashFunction>
+class ReduceTableSelect<
+        ReduceTableImpl::PROBING,
+        ValueType, std::string, Value, KeyExtractor, ReduceFunction,
+        Emitter, /* VolatileKey */ true, ReduceConfig,
+        ReduceByHash<std::string, HashFunction>, std::equal_to<std::string> >
+{
+public:
+    using type = ReduceStringProbingHashTable<
+              ValueType, Value, KeyExtractor, ReduceFunction,
+              Emitter, /* VolatileKey */ true, ReduceConfig,
+              ReduceByHash<std::string, HashFunction>,
+              std::equal_to<std::string> >;
+};
+
+} // namespace core
+
+namespace data {
+
+//! Serialize a StringKeyValueRef like a std::pair<std::string, Value>
+template <typename Archive, typename Value>
+struct Serialization<Archive, core::StringKeyValueRef<Value> >
+{
+    static void Serialize(const core::StringKeyValueRef<Value>& x,
+                          Archive& ar) {
+        ar.PutString(x.key(), x.size());
+        Serialization<Archive, Value>::Serialize(x.value(), ar);
+    }
+    static constexpr bool   is_fixed_size = false;
+    static constexpr size_t fixed_size = 0;
+};
+
+} // namespace data
+} // namespace thrill
+
+#endif // !THRILL_CORE_REDUCE_STRING_PROBING_HASH_TABLE_HEADER
+
+/******************************************************************************/
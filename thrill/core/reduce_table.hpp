@@ -64,6 +64,10 @@ public:
     //! the pre and post stages simultaneously.
     static constexpr bool use_post_thread_ = true;
 
+    //! only for ReduceToIndexNode: reduce into a dense array indexed by key
+    //! instead of hash tables, if the result array fits into RAM.
+    static constexpr bool use_dense_array_ = true;
+
     //! \name Accessors
     //! \{
 
@@ -134,6 +138,9 @@ public:
         if (!immediate_flush_) {
             for (size_t i = 0; i < num_partitions_; i++) {
                 partition_files_.push_back(ctx.GetFile(dia_id_));
+                // spilled partitions are read back once in the second phase.
+                partition_files_.back().SetEvictionHint(
+                    data::EvictionHint::ReadOnce);
             }
         }
     }
@@ -14,12 +14,15 @@
 #include <thrill/common/math.hpp>
 #include <thrill/data/block.hpp>
 #include <thrill/data/block_pool.hpp>
+#include <thrill/io/exceptions.hpp>
 #include <thrill/io/file_base.hpp>
 #include <thrill/io/iostats.hpp>
 
 #include <algorithm>
 #include <functional>
+#include <iterator>
 #include <limits>
+#include <map>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -117,12 +120,26 @@ using ReadingMap = std::unordered_map<
           mem::GPoolAllocator<
               std::pair<ByteBlock* const, PinRequestPtr> > >;
 
+//! type of the map of unpinned ByteBlocks of a File ordered by allocation.
+using FileBlockMap = std::map<
+          size_t, ByteBlock*, std::less<size_t>,
+          mem::GPoolAllocator<std::pair<const size_t, ByteBlock*> > >;
+
+//! type of the map of File ids to the File's unpinned ByteBlocks
+using UnpinnedFileMap = std::unordered_map<
+          size_t, FileBlockMap, std::hash<size_t>, std::equal_to<size_t>,
+          mem::GPoolAllocator<std::pair<const size_t, FileBlockMap> > >;
+
 struct BlockPool::Data
 {
     //! list of all blocks that are _in_memory_ but are _not_ pinned.
     common::LruCacheSet<
         ByteBlock*, mem::GPoolAllocator<ByteBlock*> > unpinned_blocks_;
 
+    //! unpinned blocks in unpinned_blocks_ which were allocated for a File,
+    //! indexed by File id and allocation order, used for coalesced eviction.
+    UnpinnedFileMap                                   unpinned_files_;
+
     //! set of ByteBlocks currently begin written to EM.
     WritingMap                                        writing_;
 
@@ -134,11 +151,57 @@ struct BlockPool::Data
         ByteBlock*, std::hash<ByteBlock*>, std::equal_to<ByteBlock*>,
         mem::GPoolAllocator<ByteBlock*> >             swapped_;
 
+    //! set of ByteBlocks in memory (pinned or unpinned), which were read from
+    //! EM and still have a valid copy there. Since ByteBlocks are never
+    //! modified after writing, these can be evicted without writing.
+    std::unordered_set<
+        ByteBlock*, std::hash<ByteBlock*>, std::equal_to<ByteBlock*>,
+        mem::GPoolAllocator<ByteBlock*> >             clean_;
+
+    //! set of ByteBlocks in memory currently being written to EM by the
+    //! background write-back, which become clean when completed.
+    WritingMap                                        writeback_;
+
     //! I/O layer stats when BlockPool was created.
     io::StatsData                                     io_stats_first_;
 
     //! I/O layer stats of previous profile tick
     io::StatsData                                     io_stats_prev_;
+
+    //! true if block has a copy in EM or is being written back to it.
+    bool IsWrittenBack(ByteBlock* block_ptr) const {
+        return clean_.count(block_ptr) || writeback_.count(block_ptr);
+    }
+
+    //! insert block into the unpinned list and the File index.
+    void PutUnpinned(ByteBlock* block_ptr) {
+        unpinned_blocks_.put(block_ptr);
+        if (block_ptr->file_id_ != 0)
+            unpinned_files_[block_ptr->file_id_][block_ptr->seq_] = block_ptr;
+    }
+
+    //! remove block from the unpinned list and the File index.
+    void EraseUnpinned(ByteBlock* block_ptr) {
+        unpinned_blocks_.erase(block_ptr);
+        EraseUnpinnedFile(block_ptr);
+    }
+
+    //! remove least recently used block from the unpinned list.
+    ByteBlock * PopUnpinned() {
+        ByteBlock* block_ptr = unpinned_blocks_.pop();
+        EraseUnpinnedFile(block_ptr);
+        return block_ptr;
+    }
+
+    //! remove block from the File index
+    void EraseUnpinnedFile(ByteBlock* block_ptr) {
+        if (block_ptr->file_id_ == 0) return;
+        UnpinnedFileMap::iterator it = unpinned_files_.find(block_ptr->file_id_);
+        die_unless(it != unpinned_files_.end());
+        die_unequal(it->second.erase(block_ptr->seq_), 1u);
+        if (it->second.empty())
+            unpinned_files_.erase(it);
+    }
 };
 
 /******************************************************************************/
@@ -182,6 +245,14 @@ BlockPool::BlockPool(size_t soft_ram_limit, size_t hard_ram_limit,
 BlockPool::~BlockPool() {
     std::unique_lock<std::mutex> lock(mutex_);
 
+    // cancel background write-backs.
+    while (d_->writeback_.begin() != d_->writeback_.end()) {
+        io::RequestPtr req = d_->writeback_.begin()->second;
+        lock.unlock();
+        if (!req->cancel()) req->wait();
+        lock.lock();
+    }
+
     // check that not writing any block.
     while (d_->writing_.begin() != d_->writing_.end()) {
 
@@ -241,6 +312,7 @@ BlockPool::~BlockPool() {
     pin_count_.AssertZero();
     die_unequal(total_ram_bytes_, 0);
     die_unequal(d_->unpinned_blocks_.size(), 0);
+    die_unequal(d_->clean_.size(), 0);
 
     LOGC(debug_pin)
         << "~BlockPool()"
@@ -258,7 +330,8 @@ BlockPool::~BlockPool() {
 }
 
 PinnedByteBlockPtr
-BlockPool::AllocateByteBlock(size_t size, size_t local_worker_id) {
+BlockPool::AllocateByteBlock(
+    size_t size, size_t local_worker_id, size_t file_id) {
     assert(local_worker_id < workers_per_host_);
     std::unique_lock<std::mutex> lock(mutex_);
 
@@ -281,6 +354,8 @@ BlockPool::AllocateByteBlock(size_t size, size_t local_worker_id) {
     // create common::CountingPtr, no need for special make_shared()-equivalent
     PinnedByteBlockPtr block_ptr(
         mem::GPool().make<ByteBlock>(this, data, size), local_worker_id);
+    block_ptr->file_id_ = file_id;
+    block_ptr->seq_ = ++next_block_seq_;
     ++total_byte_blocks_;
     IntIncBlockPinCount(block_ptr.get(), local_worker_id);
 
@@ -408,7 +483,7 @@ PinRequestPtr BlockPool::PinBlock(const Block& block, size_t local_worker_id) {
 
         // remove from unpinned list
         die_unless(d_->unpinned_blocks_.exists(block_ptr));
-        d_->unpinned_blocks_.erase(block_ptr);
+        d_->EraseUnpinned(block_ptr);
         unpinned_bytes_ -= block_ptr->size();
 
         IntIncBlockPinCount(block_ptr, local_worker_id);
@@ -515,10 +590,21 @@ void BlockPool::OnReadComplete(
         // set pin on ByteBlock
         IntIncBlockPinCount(block_ptr, read->block_.local_worker_id_);
 
-        if (!block_ptr->ext_file_) {
+        if (block_ptr->ext_file_) {
+            // nothing to do, the external file remains.
+        }
+        else if (block_ptr->eviction_hint_ == EvictionHint::ReadOnce) {
+            // the block will not be read again, hence it is very unlikely to
+            // be evicted again: free the EM copy right away.
             bm_->delete_block(block_ptr->em_bid_);
             block_ptr->em_bid_ = io::BID<0>();
         }
+        else {
+            // keep the EM copy, the block can be evicted again without
+            // writing. The EM block is deleted lazily, see
+            // IntReleaseCleanBlocks().
+            d_->clean_.insert(block_ptr);
+        }
     }
 
     read->ready_ = true;
@@ -597,7 +683,7 @@ void BlockPool::IntUnpinBlock(ByteBlock* block_ptr, size_t local_worker_id) {
 
     // if all per-thread pins are zero, allow this Block to be swapped out.
     die_unless(!d_->unpinned_blocks_.exists(block_ptr));
-    d_->unpinned_blocks_.put(block_ptr);
+    d_->PutUnpinned(block_ptr);
     unpinned_bytes_ += block_ptr->size();
 
     LOGC(debug_pin)
@@ -669,6 +755,16 @@ size_t BlockPool::reading_blocks() noexcept {
     return d_->reading_.size();
 }
 
+size_t BlockPool::clean_blocks() noexcept {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return d_->clean_.size();
+}
+
+size_t BlockPool::writeback_blocks() noexcept {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return d_->writeback_.size();
+}
+
 void BlockPool::DestroyBlock(ByteBlock* block_ptr) {
     LOGC(debug_blc)
         << "BlockPool::DestroyBlock() block_ptr=" << block_ptr
@@ -703,6 +799,16 @@ void BlockPool::DestroyBlock(ByteBlock* block_ptr) {
                 // evicting the unlocked time.
                 continue;
             }
+
+            // block may be written back to EM in the background.
+            it = d_->writeback_.find(block_ptr);
+            if (it != d_->writeback_.end()) {
+                io::RequestPtr req = it->second;
+                lock.unlock();
+                if (!req->cancel()) req->wait();
+                lock.lock();
+                continue;
+            }
         }
         else
         {
@@ -736,7 +842,7 @@ void BlockPool::DestroyBlock(ByteBlock* block_ptr) {
             << " external block, in memory: release memory.";
 
         die_unless(d_->unpinned_blocks_.exists(block_ptr));
-        d_->unpinned_blocks_.erase(block_ptr);
+        d_->EraseUnpinned(block_ptr);
         unpinned_bytes_ -= block_ptr->size();
 
         // release memory
@@ -759,9 +865,15 @@ void BlockPool::DestroyBlock(ByteBlock* block_ptr) {
             << " unpinned block in memory, remove from list";
 
         die_unless(d_->unpinned_blocks_.exists(block_ptr));
-        d_->unpinned_blocks_.erase(block_ptr);
+        d_->EraseUnpinned(block_ptr);
         unpinned_bytes_ -= block_ptr->size();
 
+        // delete clean EM copy
+        if (d_->clean_.erase(block_ptr)) {
+            bm_->delete_block(block_ptr->em_bid_);
+            block_ptr->em_bid_ = io::BID<0>();
+        }
+
         // release memory
         aligned_alloc_.deallocate(block_ptr->data_, block_ptr->size());
         block_ptr->data_ = nullptr;
@@ -922,12 +1034,17 @@ void BlockPool::EvictBlock(ByteBlock* block_ptr) {
     die_unless(block_ptr->in_memory());
 
     die_unless(d_->unpinned_blocks_.exists(block_ptr));
-    d_->unpinned_blocks_.erase(block_ptr);
+    d_->EraseUnpinned(block_ptr);
     unpinned_bytes_ -= block_ptr->size();
 
     IntEvictBlock(block_ptr);
 }
 
+void BlockPool::SetEvictionHint(ByteBlock* block_ptr, EvictionHint hint) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    block_ptr->eviction_hint_ = hint;
+}
+
 io::RequestPtr BlockPool::GetAnyWriting() {
     std::unique_lock<std::mutex> lock(mutex_);
     if (!d_->writing_.size()) return io::RequestPtr();
@@ -943,11 +1060,62 @@ io::RequestPtr BlockPool::IntEvictBlockLRU() {
 
     if (!d_->unpinned_blocks_.size()) return io::RequestPtr();
 
-    ByteBlock* block_ptr = d_->unpinned_blocks_.pop();
+    ByteBlock* block_ptr = d_->unpinned_blocks_.peek();
     die_unless(block_ptr);
-    unpinned_bytes_ -= block_ptr->size();
 
-    return IntEvictBlock(block_ptr);
+    UnpinnedFileMap::iterator fit = d_->unpinned_files_.end();
+    bool backward = false;
+
+    if (block_ptr->file_id_ != 0) {
+        fit = d_->unpinned_files_.find(block_ptr->file_id_);
+        die_unless(fit != d_->unpinned_files_.end());
+
+        if (block_ptr->eviction_hint_ != EvictionHint::Default) {
+            // the File is read from the front: evict its last unpinned block
+            // instead of the least recently used one, since it is needed last.
+            block_ptr = fit->second.rbegin()->second;
+            backward = true;
+        }
+    }
+
+    std::vector<ByteBlock*> blocks { block_ptr };
+
+    if (fit != d_->unpinned_files_.end() && !block_ptr->ext_file_ &&
+        !d_->IsWrittenBack(block_ptr))
+    {
+        // collect dirty unpinned blocks adjacent to the victim in the same
+        // File, such that they are written sequentially into one EM extent.
+        size_t total_size = block_ptr->size();
+        auto add_block = [&](ByteBlock* b) {
+                             if (d_->IsWrittenBack(b)) return true;
+                             if (total_size + b->size() > max_coalesced_eviction_)
+                                 return false;
+                             blocks.push_back(b);
+                             total_size += b->size();
+                             return true;
+                         };
+
+        FileBlockMap& file_blocks = fit->second;
+        if (!backward) {
+            for (FileBlockMap::iterator it =
+                     file_blocks.upper_bound(block_ptr->seq_);
+                 it != file_blocks.end() && add_block(it->second); ++it) { }
+        }
+        else {
+            for (FileBlockMap::reverse_iterator it =
+                     std::next(file_blocks.rbegin());
+                 it != file_blocks.rend() && add_block(it->second); ++it) { }
+            // write blocks in File order, such that reading is sequential.
+            std::reverse(blocks.begin(), blocks.end());
+        }
+    }
+
+    for (ByteBlock* b : blocks) {
+        d_->EraseUnpinned(b);
+        unpinned_bytes_ -= b->size();
+    }
+
+    return IntEvictBlocks(blocks);
 }
 
 io::RequestPtr BlockPool::IntEvictBlock(ByteBlock* block_ptr) {
@@ -969,27 +1137,166 @@ io::RequestPtr BlockPool::IntEvictBlock(ByteBlock* block_ptr) {
         return io::RequestPtr();
     }
 
+    if (d_->clean_.erase(block_ptr)) {
+        // block has an unmodified copy in EM -> free memory without writing
+
+        LOGC(debug_em)
+            << "EvictBlock(): " << block_ptr << " - " << *block_ptr
+            << " clean, still in em_bid " << block_ptr->em_bid_;
+
+        d_->swapped_.insert(block_ptr);
+        swapped_bytes_ += block_ptr->size();
+
+        // release memory
+        aligned_alloc_.deallocate(block_ptr->data_, block_ptr->size());
+        block_ptr->data_ = nullptr;
+
+        IntReleaseInternalMemory(block_ptr->size());
+        return io::RequestPtr();
+    }
+
+    WritingMap::iterator wb_it = d_->writeback_.find(block_ptr);
+    if (wb_it != d_->writeback_.end()) {
+        // block is already being written back: turn the write into an
+        // eviction, which releases the memory when completed.
+
+        LOGC(debug_em)
+            << "EvictBlock(): " << block_ptr << " - " << *block_ptr
+            << " already being written to em_bid " << block_ptr->em_bid_;
+
+        io::RequestPtr req = std::move(wb_it->second);
+        d_->writeback_.erase(wb_it);
+        writeback_bytes_ -= block_ptr->size();
+        writing_bytes_ += block_ptr->size();
+        return (d_->writing_[block_ptr] = std::move(req));
+    }
+
     die_unless(block_ptr->em_bid_.storage == nullptr);
 
     // allocate EM block
     block_ptr->em_bid_.size = block_ptr->size();
-    bm_->new_block(io::FullyRandom(), block_ptr->em_bid_);
+    IntAllocateExternalBlock(block_ptr->em_bid_);
 
     LOGC(debug_em)
         << "EvictBlock(): " << block_ptr << " - " << *block_ptr
         << " to em_bid " << block_ptr->em_bid_;
 
+    return IntWriteBlock(block_ptr);
+}
+
+io::RequestPtr BlockPool::IntEvictBlocks(const std::vector<ByteBlock*>& blocks) {
+
+    if (blocks.size() == 1)
+        return IntEvictBlock(blocks[0]);
+
+    // allocate one EM extent for all blocks, which are then written to
+    // consecutive ranges in it. The ranges are deleted separately later.
+    io::BID<0> extent;
+    for (ByteBlock* block_ptr : blocks)
+        extent.size += block_ptr->size();
+    IntAllocateExternalBlock(extent);
+
+    LOGC(debug_em)
+        << "EvictBlocks(): " << blocks.size() << " blocks of file_id "
+        << blocks[0]->file_id_ << " to em extent " << extent;
+
+    io::RequestPtr first_req;
+    int64_t offset = extent.offset;
+    for (ByteBlock* block_ptr : blocks) {
+        die_unless(block_ptr->block_pool_ == this);
+        die_unless(block_ptr->em_bid_.storage == nullptr);
+
+        block_ptr->em_bid_ =
+            io::BID<0>(extent.storage, offset, block_ptr->size());
+        offset += block_ptr->size();
+
+        io::RequestPtr req = IntWriteBlock(block_ptr);
+        if (!first_req) first_req = req;
+    }
+    return first_req;
+}
+
+void BlockPool::IntAllocateExternalBlock(io::BID<0>& bid) {
+    try {
+        bm_->new_block(io::FullyRandom(), bid);
+    }
+    catch (io::BadExternalAlloc&) {
+        // out of disk space: drop EM copies of clean blocks and retry.
+        if (d_->clean_.empty()) throw;
+        IntReleaseCleanBlocks();
+        bm_->new_block(io::FullyRandom(), bid);
+    }
+}
+
+io::RequestPtr BlockPool::IntWriteBlock(ByteBlock* block_ptr) {
+
     writing_bytes_ += block_ptr->size();
 
+    return (d_->writing_[block_ptr] = IntStartWrite(block_ptr));
+}
+
+io::RequestPtr BlockPool::IntStartWrite(ByteBlock* block_ptr) {
     // initiate writing to EM.
-    io::RequestPtr req =
-        block_ptr->em_bid_.storage->awrite(
-            block_ptr->data_, block_ptr->em_bid_.offset, block_ptr->size(),
-            // construct an immediate CompletionHandler callback
-            io::CompletionHandler::make<
-                ByteBlock, & ByteBlock::OnWriteComplete>(block_ptr));
+    return block_ptr->em_bid_.storage->awrite(
+        block_ptr->data_, block_ptr->em_bid_.offset, block_ptr->size(),
+        // construct an immediate CompletionHandler callback
+        io::CompletionHandler::make<
+            ByteBlock, & ByteBlock::OnWriteComplete>(block_ptr));
+}
+
+void BlockPool::IntWriteBackBlocks() {
+    if (soft_ram_limit_ == 0) return;
+
+    const size_t threshold = static_cast<size_t>(
+        writeback_threshold_ * static_cast<double>(soft_ram_limit_));
 
-    return (d_->writing_[block_ptr] = std::move(req));
+    // number of bytes that can be freed by dropping cold blocks without
+    // writing them.
+    size_t clean_bytes = 0;
+
+    for (auto it = d_->unpinned_blocks_.rbegin();
+         it != d_->unpinned_blocks_.rend() &&
+         total_ram_bytes_ > threshold + clean_bytes &&
+         writeback_bytes_ < max_writeback_bytes_; ++it)
+    {
+        ByteBlock* block_ptr = *it;
+
+        if (!block_ptr->ext_file_ && !d_->IsWrittenBack(block_ptr)) {
+            die_unless(block_ptr->em_bid_.storage == nullptr);
+
+            block_ptr->em_bid_.size = block_ptr->size();
+            try {
+                IntAllocateExternalBlock(block_ptr->em_bid_);
+            }
+            catch (io::BadExternalAlloc&) {
+                // out of disk space: leave eviction to the foreground.
+                block_ptr->em_bid_ = io::BID<0>();
+                return;
+            }
+
+            LOGC(debug_em)
+                << "WriteBackBlocks(): " << block_ptr << " - " << *block_ptr
+                << " to em_bid " << block_ptr->em_bid_;
+
+            writeback_bytes_ += block_ptr->size();
+            d_->writeback_[block_ptr] = IntStartWrite(block_ptr);
+        }
+
+        clean_bytes += block_ptr->size();
+    }
+}
+
+void BlockPool::IntReleaseCleanBlocks() {
+
+    LOGC(debug_em)
+        << "IntReleaseCleanBlocks(): deleting EM copies of "
+        << d_->clean_.size() << " clean blocks";
+
+    for (ByteBlock* block_ptr : d_->clean_) {
+        bm_->delete_block(block_ptr->em_bid_);
+        block_ptr->em_bid_ = io::BID<0>();
+    }
+    d_->clean_.clear();
 }
 
 void BlockPool::OnWriteComplete(
@@ -1002,6 +1309,22 @@ void BlockPool::OnWriteComplete(
     req->check_error();
 
     die_unless(!block_ptr->ext_file_);
+
+    if (d_->writeback_.erase(block_ptr)) {
+        // background write-back: the block remains in memory (pinned or
+        // unpinned) and is now clean.
+        writeback_bytes_ -= block_ptr->size();
+
+        if (success) {
+            d_->clean_.insert(block_ptr);
+        }
+        else {
+            bm_->delete_block(block_ptr->em_bid_);
+            block_ptr->em_bid_ = io::BID<0>();
+        }
+        return;
+    }
+
     die_unequal(d_->writing_.erase(block_ptr), 1);
     writing_bytes_ -= block_ptr->size();
 
@@ -1011,7 +1334,7 @@ void BlockPool::OnWriteComplete(
         // e.g. because the block was deleted.
 
         die_unless(!d_->unpinned_blocks_.exists(block_ptr));
-        d_->unpinned_blocks_.put(block_ptr);
+        d_->PutUnpinned(block_ptr);
         unpinned_bytes_ += block_ptr->size();
 
         bm_->delete_block(block_ptr->em_bid_);
@@ -1033,6 +1356,8 @@ void BlockPool::OnWriteComplete(
 void BlockPool::RunTask(const std::chrono::steady_clock::time_point& tp) {
     std::unique_lock<std::mutex> lock(mutex_);
 
+    IntWriteBackBlocks();
+
     io::StatsData stnow(*io::Stats::GetInstance());
     io::StatsData stf = stnow - d_->io_stats_first_;
     io::StatsData stp = stnow - d_->io_stats_prev_;
@@ -1066,6 +1391,9 @@ void BlockPool::RunTask(const std::chrono::steady_clock::time_point& tp) {
             << "writing_bytes" << writing_bytes_
             << "reading_blocks" << d_->reading_.size()
             << "reading_bytes" << reading_bytes_
+            << "clean_blocks" << d_->clean_.size()
+            << "writeback_blocks" << d_->writeback_.size()
+            << "writeback_bytes" << writeback_bytes_
             << "rd_ops_total" << stf.read_ops()
             << "rd_bytes_total" << stf.read_volume()
             << "wr_ops_total" << stf.write_ops()
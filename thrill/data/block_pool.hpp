@@ -112,8 +112,10 @@ public:
     //! Allocates a byte block with the request size. May block this thread if
     //! the hard memory limit is reached, until memory is freed by another
     //! thread.  The returned Block is allocated in RAM, but with a zero pin
-    //! count.
-    PinnedByteBlockPtr AllocateByteBlock(size_t size, size_t local_worker_id);
+    //! count. If file_id is non-zero, the block may be evicted together with
+    //! other blocks of the same File.
+    PinnedByteBlockPtr AllocateByteBlock(
+        size_t size, size_t local_worker_id, size_t file_id = 0);
 
     //! Allocate a byte block from an external file, used to directly map system
     //! files to data::File.
@@ -133,6 +135,9 @@ public:
     //! swapped.
     void EvictBlock(ByteBlock* block_ptr);
 
+    //! Set the access pattern hint of a block for the eviction policy.
+    void SetEvictionHint(ByteBlock* block_ptr, EvictionHint hint);
+
     //! \name Block Statistics
     //! \{
 
@@ -157,6 +162,13 @@ public:
     //! Total number of blocks currently begin read from EM.
     size_t reading_blocks()  noexcept;
 
+    //! Total number of blocks in memory which also have a valid copy in EM.
+    size_t clean_blocks()  noexcept;
+
+    //! Total number of blocks currently being written back to EM while
+    //! remaining in memory.
+    size_t writeback_blocks()  noexcept;
+
     //! \}
 
     //! \name Methods for ProfileTask
@@ -201,6 +213,21 @@ private:
     //! next unique File id
     std::atomic<size_t> next_file_id_ { 0 };
 
+    //! allocation sequence counter of ByteBlocks
+    size_t next_block_seq_ = 0;
+
+    //! maximum number of bytes of unpinned blocks of the same File which are
+    //! written together into one contiguous EM extent.
+    static constexpr size_t max_coalesced_eviction_ = 16 * 1024 * 1024;
+
+    //! fraction of the soft RAM limit above which RunTask() writes cold
+    //! unpinned blocks back to EM in the background, while keeping them in
+    //! memory. They can then be evicted without writing.
+    static constexpr double writeback_threshold_ = 0.75;
+
+    //! maximum number of bytes being written back concurrently.
+    static constexpr size_t max_writeback_bytes_ = 64 * 1024 * 1024;
+
     //! number of unpinned bytes
     size_t unpinned_bytes_ = 0;
 
@@ -254,6 +281,10 @@ private:
     //! number of bytes currently being written to EM.
     size_t writing_bytes_ = 0;
 
+    //! number of bytes currently being written back to EM, which remain in
+    //! memory.
+    size_t writeback_bytes_ = 0;
+
     //! total number of bytes in swapped blocks
     size_t swapped_bytes_ = 0;
 
@@ -296,6 +327,9 @@ private:
     //! Returns immediately. Actual unpinning is async.
     void IntUnpinBlock(ByteBlock* block_ptr, size_t local_worker_id);
 
+    //! Delete the EM copies of all clean blocks, used to reclaim disk space.
+    void IntReleaseCleanBlocks();
+
     //! callback for async write of blocks during eviction
     void OnWriteComplete(ByteBlock* block_ptr, io::Request* req, bool success);
 
@@ -309,6 +343,23 @@ private:
     //! swapped.
     io::RequestPtr IntEvictBlock(ByteBlock* block_ptr);
 
+    //! Evict a sequence of dirty blocks of the same File into one contiguous EM
+    //! extent. The blocks must be unpinned, not swapped, and not clean.
+    io::RequestPtr IntEvictBlocks(const std::vector<ByteBlock*>& blocks);
+
+    //! Allocate a new EM block, drops clean EM copies if out of disk space.
+    void IntAllocateExternalBlock(io::BID<0>& bid);
+
+    //! Issue asynchronous write of a block to its em_bid_ for eviction.
+    io::RequestPtr IntWriteBlock(ByteBlock* block_ptr);
+
+    //! Issue asynchronous write of a block to its em_bid_.
+    io::RequestPtr IntStartWrite(ByteBlock* block_ptr);
+
+    //! Write cold unpinned blocks to EM while keeping them in memory, if the
+    //! RAM usage exceeds the write-back threshold.
+    void IntWriteBackBlocks();
+
     //! make ostream-able
     friend std::ostream& operator << (std::ostream& os, const PinCount& p);
 
@@ -49,9 +49,14 @@ public:
     //! ByteBlockPtr is a nullptr, then memory of this BlockSink is exhausted.
     virtual PinnedByteBlockPtr
     AllocateByteBlock(size_t block_size) {
-        return block_pool_->AllocateByteBlock(block_size, local_worker_id_);
+        return block_pool_->AllocateByteBlock(
+            block_size, local_worker_id_, eviction_group());
     }
 
+    //! Returns an id with which the BlockPool groups the ByteBlocks allocated
+    //! by this sink for eviction, or zero for no grouping.
+    virtual size_t eviction_group() const { return 0; }
+
     //! Release an unused ByteBlock with n bytes backing memory.
     virtual void ReleaseByteBlock(ByteBlockPtr& block) {
         block = nullptr;
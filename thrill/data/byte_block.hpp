@@ -35,6 +35,22 @@ using Byte = uint8_t;
 // forward declarations.
 class BlockPool;
 
+/*!
+ * Hints about the future access pattern of a ByteBlock, which are used by the
+ * BlockPool to select blocks for eviction instead of plain LRU order. They are
+ * usually set for all blocks of a File via File::SetEvictionHint().
+ */
+enum class EvictionHint {
+    //! no knowledge about the access pattern: evict in LRU order.
+    Default,
+    //! the File is read sequentially from the front: evict its last blocks
+    //! first, since these are needed last.
+    ReadSequential,
+    //! as ReadSequential, but the blocks are read only once and then
+    //! discarded, hence their EM copy is freed immediately when read back.
+    ReadOnce
+};
+
 /*!
  * A ByteBlock is the basic storage units of containers like File, BlockQueue,
  * etc. It consists of a fixed number of bytes without any type and meta
@@ -127,6 +143,16 @@ private:
     //! was created for directly reading binary files.
     io::FileBasePtr ext_file_;
 
+    //! id of the data::File this ByteBlock was allocated for, or zero. Used by
+    //! the BlockPool to evict blocks of the same File together.
+    size_t file_id_ = 0;
+
+    //! allocation sequence number, orders the ByteBlocks of a File.
+    size_t seq_ = 0;
+
+    //! access pattern hint for the eviction policy of the BlockPool.
+    EvictionHint eviction_hint_ = EvictionHint::Default;
+
     // BlockPool is a friend to call ctor and to manipulate data_.
     friend class BlockPool;
     // Block is a friend to call {Increase,Reduce}PinCount()
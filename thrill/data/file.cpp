@@ -41,9 +41,16 @@ File File::Copy() const {
     f.size_bytes_ = size_bytes_;
     f.stats_bytes_ = stats_bytes_;
     f.stats_items_ = stats_items_;
+    f.eviction_hint_ = eviction_hint_;
     return f;
 }
 
+void File::SetEvictionHint(EvictionHint hint) {
+    eviction_hint_ = hint;
+    for (Block& b : blocks_)
+        block_pool()->SetEvictionHint(b.byte_block().get(), hint);
+}
+
 void File::Close() {
     // 2016-02-04: Files are never closed, one can always append. This is
     // current used by the ReduceTables -tb.
@@ -80,6 +80,10 @@ public:
     //! \name Methods of a BlockSink
     //! \{
 
+    //! Blocks of a File are grouped by its id, such that the BlockPool can
+    //! evict them together.
+    size_t eviction_group() const final { return id_; }
+
     //! Append a block to this file, the block must contain given number of
     //! items after the offset first.
     void AppendPinnedBlock(const PinnedBlock& b) final {
@@ -96,6 +100,8 @@ public:
     //! items after the offset first.
     void AppendBlock(const Block& b) final {
         if (b.size() == 0) return;
+        if (eviction_hint_ != EvictionHint::Default)
+            block_pool()->SetEvictionHint(b.byte_block().get(), eviction_hint_);
         num_items_sum_.push_back(num_items() + b.num_items());
         size_bytes_ += b.size();
         stats_bytes_ += b.size();
@@ -107,6 +113,8 @@ public:
     //! items after the offset first.
     void AppendBlock(Block&& b) final {
         if (b.size() == 0) return;
+        if (eviction_hint_ != EvictionHint::Default)
+            block_pool()->SetEvictionHint(b.byte_block().get(), eviction_hint_);
         num_items_sum_.push_back(num_items() + b.num_items());
         size_bytes_ += b.size();
         stats_bytes_ += b.size();
@@ -173,6 +181,13 @@ public:
 
     //! \}
 
+    //! Set the access pattern hint of all current and future Blocks of the
+    //! File, which the BlockPool uses to select blocks for eviction.
+    void SetEvictionHint(EvictionHint hint);
+
+    //! Returns the access pattern hint for eviction
+    EvictionHint eviction_hint() const { return eviction_hint_; }
+
     //! Return the number of blocks
     size_t num_blocks() const { return blocks_.size(); }
 
@@ -281,6 +296,9 @@ private:
     //! decreases.
     size_t stats_items_ = 0;
 
+    //! access pattern hint applied to all Blocks appended to the File
+    EvictionHint eviction_hint_ = EvictionHint::Default;
+
     //! for access to blocks_ and num_items_sum_
     friend class data::KeepFileBlockSource;
     friend class data::ConsumeFileBlockSource;
@@ -21,7 +21,11 @@
 #include <thrill/common/math.hpp>
 #include <thrill/net/group.hpp>
 
+#include <algorithm>
+#include <cassert>
 #include <functional>
+#include <type_traits>
+#include <vector>
 
 namespace thrill {
 namespace net {
@@ -349,6 +353,150 @@ void AllReduceHypercube(Group& net, T& value, BinarySumOp sum_op = BinarySumOp()
     sLOG << "ALL_REDUCE_HYPERCUBE: value after all reduce " << value;
 }
 
+/******************************************************************************/
+// ReduceScatter and AllReduce Algorithms for Arrays of PODs
+
+//! \brief   Exchange one block with the ring neighbours: send send_size items
+//!          to the successor and receive recv_size items from the
+//!          predecessor.
+//! \details Hosts with even rank send first, hosts with odd rank receive
+//!          first, such that blocking sends cannot deadlock. The items are
+//!          transmitted as raw bytes without serialization.
+//!
+//! \param   net The current group onto which to apply the operation
+//! \param   send_data Items to send to the successor
+//! \param   send_size Number of items to send
+//! \param   recv_data Buffer for the items received from the predecessor
+//! \param   recv_size Number of items to receive
+template <typename T>
+static inline
+void RingExchange(Group& net, const T* send_data, size_t send_size,
+                  T* recv_data, size_t recv_size) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "RingExchange requires a trivially copyable type T");
+
+    const size_t num_hosts = net.num_hosts();
+    const size_t my_rank = net.my_host_rank();
+
+    Connection& succ = net.connection((my_rank + 1) % num_hosts);
+    Connection& pred = net.connection((my_rank + num_hosts - 1) % num_hosts);
+
+    if (my_rank % 2 == 0) {
+        if (send_size != 0) succ.SyncSend(send_data, send_size * sizeof(T));
+        if (recv_size != 0) pred.SyncRecv(recv_data, recv_size * sizeof(T));
+    }
+    else {
+        if (recv_size != 0) pred.SyncRecv(recv_data, recv_size * sizeof(T));
+        if (send_size != 0) succ.SyncSend(send_data, send_size * sizeof(T));
+    }
+}
+
+//! \brief   Perform a Reduce-Scatter of an array of PODs with the ring
+//!          algorithm.
+//! \details The array is divided into num_hosts blocks, where block i is
+//!          [offsets[i], offsets[i+1]). Afterwards, block i on host i
+//!          contains the element-wise reduction of block i of all hosts, the
+//!          other blocks contain arbitrary data. Each host sends and receives
+//!          (p-1)/p of the array, which is bandwidth-optimal. The reduction
+//!          order is rotated, hence sum_op must be commutative.
+//!
+//! \param   net The current group onto which to apply the operation
+//! \param   values Array of items which is reduced in place
+//! \param   offsets Block boundaries, num_hosts + 1 ascending offsets
+//! \param   sum_op A custom summation operator
+template <typename T, typename BinarySumOp = std::plus<T> >
+static inline
+void ReduceScatterRing(Group& net, T* values,
+                       const std::vector<size_t>& offsets,
+                       BinarySumOp sum_op = BinarySumOp()) {
+    const size_t num_hosts = net.num_hosts();
+    const size_t my_rank = net.my_host_rank();
+    assert(offsets.size() == num_hosts + 1);
+
+    size_t max_block = 0;
+    for (size_t i = 0; i < num_hosts; ++i)
+        max_block = std::max(max_block, offsets[i + 1] - offsets[i]);
+
+    std::vector<T> recv(max_block);
+
+    // in step s, send the partial sum of block (r-s-1) to the successor and
+    // add the predecessor's partial sum of block (r-s-2), such that block r is
+    // completed in the last step.
+    for (size_t s = 0; s + 1 < num_hosts; ++s) {
+        size_t send_block = (my_rank + 2 * num_hosts - s - 1) % num_hosts;
+        size_t recv_block = (my_rank + 2 * num_hosts - s - 2) % num_hosts;
+
+        size_t recv_size = offsets[recv_block + 1] - offsets[recv_block];
+
+        RingExchange(net, values + offsets[send_block],
+                     offsets[send_block + 1] - offsets[send_block],
+                     recv.data(), recv_size);
+
+        T* block = values + offsets[recv_block];
+        for (size_t i = 0; i < recv_size; ++i)
+            block[i] = sum_op(recv[i], block[i]);
+    }
+}
+
+//! \brief   Perform an All-Gather of an array of PODs with the ring
+//!          algorithm.
+//! \details Block i = [offsets[i], offsets[i+1]) of host i is copied into
+//!          block i of all other hosts.
+//!
+//! \param   net The current group onto which to apply the operation
+//! \param   values Array of items, afterwards contains all blocks
+//! \param   offsets Block boundaries, num_hosts + 1 ascending offsets
+template <typename T>
+static inline
+void AllGatherRing(Group& net, T* values, const std::vector<size_t>& offsets) {
+    const size_t num_hosts = net.num_hosts();
+    const size_t my_rank = net.my_host_rank();
+    assert(offsets.size() == num_hosts + 1);
+
+    // in step s, forward block (r-s) and receive block (r-s-1).
+    for (size_t s = 0; s + 1 < num_hosts; ++s) {
+        size_t send_block = (my_rank + num_hosts - s) % num_hosts;
+        size_t recv_block = (my_rank + 2 * num_hosts - s - 1) % num_hosts;
+
+        RingExchange(net, values + offsets[send_block],
+                     offsets[send_block + 1] - offsets[send_block],
+                     values + offsets[recv_block],
+                     offsets[recv_block + 1] - offsets[recv_block]);
+    }
+}
+
+//! \brief   Calculate the block offsets of an array of size items, which are
+//!          equally divided among the hosts using common::CalculateLocalRange.
+static inline
+std::vector<size_t> RingOffsets(size_t num_hosts, size_t size) {
+    std::vector<size_t> offsets(num_hosts + 1);
+    for (size_t i = 0; i < num_hosts; ++i)
+        offsets[i] = common::CalculateLocalRange(size, num_hosts, i).begin;
+    offsets[num_hosts] = size;
+    return offsets;
+}
+
+//! \brief   Perform an element-wise All-Reduce of an array of PODs.
+//! \details This is done with a ring Reduce-Scatter followed by a ring
+//!          All-Gather, which transmits 2 (p-1)/p times the array per host
+//!          instead of log(p) times with the Hypercube algorithm. sum_op must
+//!          be commutative.
+//!
+//! \param   net The current group onto which to apply the operation
+//! \param   values Array of items which is reduced in place
+//! \param   size Number of items in the array, equal on all hosts
+//! \param   sum_op A custom summation operator
+template <typename T, typename BinarySumOp = std::plus<T> >
+static inline
+void AllReduceRing(Group& net, T* values, size_t size,
+                   BinarySumOp sum_op = BinarySumOp()) {
+    if (net.num_hosts() == 1) return;
+
+    std::vector<size_t> offsets = RingOffsets(net.num_hosts(), size);
+    ReduceScatterRing(net, values, offsets, sum_op);
+    AllGatherRing(net, values, offsets);
+}
+
 //! \}
 
 } // namespace collective
@@ -385,6 +533,19 @@ void Group::AllReduce(T& value, BinarySumOp sum_op) {
     return collective::AllReduce(*this, value, sum_op);
 }
 
+//! Reduce an array of PODs element-wise, host i receives block i of the result
+template <typename T, typename BinarySumOp>
+void Group::ReduceScatter(T* values, size_t size, BinarySumOp sum_op) {
+    return collective::ReduceScatterRing(
+        *this, values, collective::RingOffsets(num_hosts(), size), sum_op);
+}
+
+//! Reduce an array of PODs element-wise from all workers to all workers
+template <typename T, typename BinarySumOp>
+void Group::AllReduceArray(T* values, size_t size, BinarySumOp sum_op) {
+    return collective::AllReduceRing(*this, values, size, sum_op);
+}
+
 } // namespace net
 } // namespace thrill
 
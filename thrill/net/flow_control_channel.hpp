@@ -15,6 +15,7 @@
 
 #include <thrill/common/defines.hpp>
 #include <thrill/common/functional.hpp>
+#include <thrill/common/math.hpp>
 #include <thrill/common/thread_barrier.hpp>
 #include <thrill/net/collective.hpp>
 #include <thrill/net/group.hpp>
@@ -24,6 +25,7 @@
 #include <functional>
 #include <mutex>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace thrill {
@@ -154,6 +156,37 @@ private:
 
     //! \}
 
+    //! Element-wise reduction of the vectors of all local workers into the
+    //! vector of local worker 0, which is returned. Each worker reduces a
+    //! slice of the vectors, hence the work is parallelized.
+    template <typename T, typename BinarySumOp>
+    std::vector<T>* LocalReduceVector(std::vector<T>& local,
+                                      const BinarySumOp& sum_op) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Vector collectives require a trivially copyable type T");
+
+        SetLocalShared(&local);
+
+        barrier_.Await();
+
+        std::vector<T>* sum = GetLocalShared<std::vector<T> >(0);
+        const size_t size = sum->size();
+        assert(local.size() == size);
+
+        common::Range slice =
+            common::CalculateLocalRange(size, thread_count_, local_id_);
+
+        for (size_t t = 1; t < thread_count_; ++t) {
+            const std::vector<T>& other = *GetLocalShared<std::vector<T> >(t);
+            for (size_t i = slice.begin; i < slice.end; ++i)
+                (*sum)[i] = sum_op((*sum)[i], other[i]);
+        }
+
+        barrier_.Await();
+
+        return sum;
+    }
+
 public:
     //! Creates a new instance of this class, wrapping a group.
     FlowControlChannel(Group& group,
@@ -329,6 +362,42 @@ public:
         return res;
     }
 
+    /*!
+     * Broadcasts a value of type T from one local worker to all other workers
+     * on the same host. No network communication is performed, hence T need not
+     * be serializable, and is usually a (shared) pointer to a host-wide data
+     * structure.
+     *
+     * This method is blocking on all local workers.
+     *
+     * \param value The value to broadcast. This value is ignored for each
+     * worker except the local origin.
+     *
+     * \param local_origin Local worker id to broadcast value from.
+     *
+     * \return The value of the local origin.
+     */
+    template <typename T>
+    T THRILL_ATTRIBUTE_WARN_UNUSED_RESULT
+    LocalBroadcast(const T& value, size_t local_origin = 0) {
+        assert(local_origin < thread_count_);
+
+        T res = value;
+
+        if (local_id_ == local_origin)
+            SetLocalShared(&res);
+
+        barrier_.Await();
+
+        // other threads: copy value from the local origin.
+        if (local_id_ != local_origin)
+            res = *GetLocalShared<T>(local_origin);
+
+        barrier_.Await();
+
+        return res;
+    }
+
     /*!
      * Reduces a value of a serializable type T over all workers to the given
      * worker, provided a certain reduce function.
@@ -418,6 +487,94 @@ public:
         return local;
     }
 
+    /*!
+     * Reduces a vector of PODs element-wise over all workers, given a certain
+     * reduce function. All workers must pass vectors of equal size.
+     *
+     * The local workers first combine their vectors via shared memory, where
+     * each worker reduces a slice of all local vectors. Then one worker per
+     * host performs a bandwidth-optimal ring AllReduce over the network. The
+     * operation is assumed to be associative and commutative.
+     *
+     * \param values The local vector to use for the reduce operation.
+     * \param sum_op The operation to use for
+     * calculating the reduced value. The default operation is a normal addition.
+     * \return The element-wise reduction of all workers' vectors.
+     */
+    template <typename T, typename BinarySumOp = std::plus<T> >
+    std::vector<T> THRILL_ATTRIBUTE_WARN_UNUSED_RESULT
+    AllReduceVector(const std::vector<T>& values,
+                    const BinarySumOp& sum_op = BinarySumOp()) {
+        std::vector<T> local = values;
+
+        std::vector<T>* sum = LocalReduceVector(local, sum_op);
+
+        if (local_id_ == 0)
+            group_.AllReduceArray(sum->data(), sum->size(), sum_op);
+
+        barrier_.Await();
+
+        // other threads: copy result from thread 0.
+        if (local_id_ != 0)
+            local = *sum;
+
+        barrier_.Await();
+
+        return local;
+    }
+
+    /*!
+     * Reduces a vector of PODs element-wise over all workers and scatters the
+     * result: each worker receives only the part of the reduced vector given by
+     * ReduceScatterRange(values.size(), my_rank()). All workers must pass
+     * vectors of equal size. The vector is taken by value, such that callers
+     * can move it in instead of copying it.
+     *
+     * As with AllReduceVector(), the local vectors are first combined via
+     * shared memory, then the hosts perform a ring ReduceScatter. The operation
+     * is assumed to be associative and commutative.
+     *
+     * \param values The local vector to use for the reduce operation.
+     * \param sum_op The operation to use for
+     * calculating the reduced value. The default operation is a normal addition.
+     * \return This worker's range of the element-wise reduction.
+     */
+    template <typename T, typename BinarySumOp = std::plus<T> >
+    std::vector<T> THRILL_ATTRIBUTE_WARN_UNUSED_RESULT
+    ReduceScatter(std::vector<T> values,
+                  const BinarySumOp& sum_op = BinarySumOp()) {
+        std::vector<T>* sum = LocalReduceVector(values, sum_op);
+
+        const size_t size = sum->size();
+
+        if (local_id_ == 0) {
+            // each host receives the ranges of all of its workers
+            std::vector<size_t> offsets(num_hosts_ + 1);
+            for (size_t h = 0; h < num_hosts_; ++h)
+                offsets[h] = ReduceScatterRange(size, h * thread_count_).begin;
+            offsets[num_hosts_] = size;
+
+            collective::ReduceScatterRing(
+                group_, sum->data(), offsets, sum_op);
+        }
+
+        barrier_.Await();
+
+        common::Range range = ReduceScatterRange(size, my_rank());
+        std::vector<T> result(sum->begin() + range.begin,
+                              sum->begin() + range.end);
+
+        barrier_.Await();
+
+        return result;
+    }
+
+    //! Returns the range of a vector of size items which worker receives from
+    //! ReduceScatter().
+    common::Range ReduceScatterRange(size_t size, size_t worker) const {
+        return common::CalculateLocalRange(size, num_workers(), worker);
+    }
+
     /*!
      * Collects up to k predecessors of type T from preceding PEs. k must be
      * equal on all PEs.
@@ -143,6 +143,17 @@ public:
     template <typename T, typename BinarySumOp = std::plus<T> >
     void AllReduce(T& value, BinarySumOp sum_op = BinarySumOp());
 
+    //! Reduce an array of PODs element-wise, host i receives block i of the
+    //! result as given by common::CalculateLocalRange.
+    template <typename T, typename BinarySumOp = std::plus<T> >
+    void ReduceScatter(T* values, size_t size,
+                       BinarySumOp sum_op = BinarySumOp());
+
+    //! Reduce an array of PODs element-wise from all workers to all workers
+    template <typename T, typename BinarySumOp = std::plus<T> >
+    void AllReduceArray(T* values, size_t size,
+                        BinarySumOp sum_op = BinarySumOp());
+
     //! \}
 
 protected:
@@ -17,9 +17,12 @@
 print "#include <$_>\n" foreach sort glob("thrill/api/"."*.hpp");
 ]]]*/
 #include <thrill/api/action_node.hpp>
+#include <thrill/api/aggregate_by_key.hpp>
 #include <thrill/api/all_gather.hpp>
 #include <thrill/api/all_reduce.hpp>
+#include <thrill/api/approx_distinct_count.hpp>
 #include <thrill/api/bernoulli_sample.hpp>
+#include <thrill/api/broadcast_join.hpp>
 #include <thrill/api/cache.hpp>
 #include <thrill/api/collapse.hpp>
 #include <thrill/api/concat.hpp>
@@ -28,6 +31,7 @@ print "#include <$_>\n" foreach sort glob("thrill/api/"."*.hpp");
 #include <thrill/api/dia.hpp>
 #include <thrill/api/dia_base.hpp>
 #include <thrill/api/dia_node.hpp>
+#include <thrill/api/distinct.hpp>
 #include <thrill/api/distribute.hpp>
 #include <thrill/api/dop_node.hpp>
 #include <thrill/api/equal_to_dia.hpp>
@@ -45,6 +49,7 @@ print "#include <$_>\n" foreach sort glob("thrill/api/"."*.hpp");
 #include <thrill/api/print.hpp>
 #include <thrill/api/read_binary.hpp>
 #include <thrill/api/read_lines.hpp>
+#include <thrill/api/rebalance.hpp>
 #include <thrill/api/reduce_by_key.hpp>
 #include <thrill/api/reduce_to_index.hpp>
 #include <thrill/api/sample.hpp>